@@ -26,6 +26,36 @@ async function postJson(url, data) {
     });
 }
 
+/**
+ * Décode la réponse de /api/history.bin : en-tête de 16 octets (magic "HHB1",
+ * version, taille d'enregistrement, from, to) puis enregistrements
+ * { u32 time, i16 temp (dixièmes de °C), u8 hum (255 = inconnue), u8 duty }.
+ * @param {ArrayBuffer} buffer - Le corps de la réponse.
+ * @returns {object} Colonnes { time, temp, hum, duty } ; temp en °C, hum NaN si inconnue.
+ */
+function decodeHistory(buffer) {
+    const view = new DataView(buffer);
+    if (buffer.byteLength < 16 || view.getUint32(0, true) !== 0x31424848) {
+        throw new Error('Format d\'historique binaire invalide');
+    }
+    const recordSize = view.getUint16(6, true);
+    const count = Math.floor((buffer.byteLength - 16) / recordSize);
+    const history = {
+        time: new Uint32Array(count),
+        temp: new Float32Array(count),
+        hum: new Float32Array(count),
+        duty: new Uint8Array(count)
+    };
+    for (let i = 0, offset = 16; i < count; i++, offset += recordSize) {
+        history.time[i] = view.getUint32(offset, true);
+        history.temp[i] = view.getInt16(offset + 4, true) / 10;
+        const hum = view.getUint8(offset + 6);
+        history.hum[i] = hum === 255 ? NaN : hum;
+        history.duty[i] = view.getUint8(offset + 7);
+    }
+    return history;
+}
+
 export const api = {
     /**
      * Récupère l'état actuel des capteurs et du chauffage.
@@ -33,6 +63,41 @@ export const api = {
      */
     getStatus: () => fetchJson('/api/status'),
 
+    /**
+     * Ouvre le canal Server-Sent Events du statut (/api/events). Le serveur
+     * envoie l'état complet à la connexion, puis un delta par cycle de régulation.
+     * @param {object} handlers - Rappels { status(delta), safety(event), open(), error() }.
+     * @returns {EventSource} La connexion (à fermer avec close()).
+     */
+    openStatusEvents: (handlers) => {
+        const source = new EventSource('/api/events');
+        source.addEventListener('status', (e) => handlers.status?.(JSON.parse(e.data)));
+        source.addEventListener('safety', (e) => handlers.safety?.(JSON.parse(e.data)));
+        source.onopen = () => handlers.open?.();
+        source.onerror = () => handlers.error?.();
+        return source;
+    },
+
+    /**
+     * Récupère les agrégats min/moyenne/max de l'historique.
+     * @param {string} resolution - 'day' (jusqu'à 400 jours) ou 'hour' (jusqu'à 32 jours).
+     * @param {number} limit - Nombre de périodes les plus récentes.
+     * @returns {Promise<Array<object>>} Les périodes, de la plus ancienne à la plus récente.
+     */
+    getHistoryRollup: (resolution = 'day', limit = 365) => fetchJson(`/api/history/rollup?res=${resolution}&limit=${limit}`),
+
+    /**
+     * Récupère l'historique minute par minute au format binaire compact.
+     * @param {object} params - Fenêtre optionnelle { from, to, limit, step } (heures Unix, secondes).
+     * @returns {Promise<object>} Colonnes { time, temp, hum, duty }, de la plus ancienne à la plus récente.
+     */
+    getHistory: (params = {}) => fetch(`/api/history.bin?${new URLSearchParams(params)}`)
+        .then(res => {
+            if (!res.ok) throw new Error(`HTTP error! status: ${res.status}`);
+            return res.arrayBuffer();
+        })
+        .then(decodeHistory),
+
     /**
      * Récupère la configuration complète du système.
      * @returns {Promise<object>} L'objet de configuration.
@@ -46,6 +111,19 @@ export const api = {
      */
     applyAllSettings: (config) => postJson('/api/config', config),
 
+    /**
+     * Modifie seulement quelques champs de la configuration (unités de getCurrentConfig).
+     * @param {object} fields - Les champs modifiés, ex. { setpoint: 245 }.
+     * @returns {Promise<object>} { fields } : le masque des champs à sauvegarder.
+     */
+    patchConfig: (fields) => fetchJson('/api/config', {
+        method: 'PATCH',
+        headers: {
+            'Content-Type': 'application/json'
+        },
+        body: JSON.stringify(fields)
+    }),
+
     /**
      * Récupère la liste des profils de configuration disponibles.
      * @returns {Promise<Array<object>>} La liste des profils.
@@ -95,6 +173,13 @@ export const api = {
      */
     saveDayData: (dayIndex, temperatures) => postJson('/api/seasonal/day', { day: dayIndex, temps: temperatures }),
 
+    /**
+     * Sauvegarde plusieurs jours en une seule requête.
+     * @param {Array<object>} days - Les jours { day, temps } (24 températures chacun).
+     * @returns {Promise<Response>} La réponse du serveur.
+     */
+    saveDaysData: (days) => postJson('/api/seasonal/day', days),
+
     /**
      * Récupère les données de température annuelles pour la heatmap.
      * @returns {Promise<object>} Les données annuelles.
@@ -102,29 +187,121 @@ export const api = {
     getYearlyTemperatures: () => fetch('/api/seasonal/yearly').then(res => res.arrayBuffer()),
 
     /**
-     * Récupère les informations sur le stream MJPEG.
-     * @returns {Promise<object>} Les informations du stream.
+     * Récupère les informations sur le stream MJPEG et son réglage adaptatif.
+     * @returns {Promise<object>} { stream_url, clients, adaptive, resolution, width, height, quality, level, levels, targetFps, captureFps, achievedFps, sendMs, backlogFrames }.
      */
     getMjpegInfo: () => fetchJson('/mjpeg/info'),
 
     /**
-     * Applique la courbe de température actuelle à toute l'année.
-     * @param {Array<number>} tempCurve - La courbe de température à appliquer.
+     * Fixe le débit que le flux adaptatif cherche à tenir.
+     * @param {number} fps - Images par seconde visées (1 à 30).
      * @returns {Promise<Response>} La réponse du serveur.
      */
-    applyYearlyCurve: (tempCurve) => postJson('/api/applyYearlyCurve', { tempCurve }),
+    setStreamFps: (fps) => fetch(`/api/camera/set?fps=${fps}`, { method: 'POST' }),
+
+    /**
+     * Récupère les événements de la détection de mouvement.
+     * @returns {Promise<object>} { enabled, bytes, maxBytes, cpu, events: [{ id, time, frames, score, bytes }] }.
+     */
+    getCameraEvents: () => fetchJson('/api/camera/events'),
+
+    /**
+     * Construit l'URL d'une image d'événement.
+     * @param {number} id - L'identifiant de l'événement.
+     * @param {number} frame - Le numéro de l'image dans la rafale.
+     * @returns {string} L'URL de l'image.
+     */
+    cameraEventFrameUrl: (id, frame = 0) => `/api/camera/events/frame?id=${id}&n=${frame}`,
+
+    /**
+     * Récupère la liste des jours du time-lapse.
+     * @returns {Promise<object>} { minutes, bytes, maxBytes, dropped, days: [{ date, frames, bytes }] }.
+     */
+    getTimelapse: () => fetchJson('/api/timelapse'),
+
+    /**
+     * Construit l'URL de téléchargement d'un jour du time-lapse.
+     * @param {number} date - Le jour (AAAAMMJJ).
+     * @param {string} format - 'mjpeg' ou 'multipart'.
+     * @returns {string} L'URL du fichier.
+     */
+    timelapseDayUrl: (date, format = 'mjpeg') => `/api/timelapse/day?date=${date}&format=${format}`,
+
+    /**
+     * Applique la courbe de température actuelle à toute l'année. Le serveur
+     * réécrit l'année en tâche de fond ; la promesse attend la fin du travail.
+     * @param {Array<number>} tempCurve - La courbe de température à appliquer.
+     * @returns {Promise<object>} L'état final du travail { job, state }.
+     */
+    applyYearlyCurve: (tempCurve) => postJson('/api/applyYearlyCurve', { tempCurve })
+        .then(({ job }) => api.waitForJob(job)),
+
+    /**
+     * Interroge /api/jobs jusqu'à la fin d'un travail de fond.
+     * @param {number} job - L'identifiant renvoyé (réponse 202).
+     * @param {number} intervalMs - Période d'interrogation.
+     * @returns {Promise<object>} { job, state: 'done' } ; rejetée si le travail échoue.
+     */
+    waitForJob: async (job, intervalMs = 250) => {
+        for (;;) {
+            const status = await fetchJson(`/api/jobs?id=${job}`);
+            if (status.state === 'done') return status;
+            if (status.state === 'failed') throw new Error(`Travail ${job} en échec`);
+            await new Promise(resolve => setTimeout(resolve, intervalMs));
+        }
+    },
+
+    /**
+     * Lisse l'année sur le serveur, entre jours voisins puis entre heures voisines.
+     * @param {object} options - { month } ou { from, to } (jours, toute l'année par défaut),
+     *   kernel ('gaussian' ou 'box'), days (rayon en jours, 3), hours (rayon en heures, 1).
+     * @returns {Promise<object>} L'état final du travail { job, state }.
+     */
+    smoothSeasonalData: (options = {}) => postJson('/api/seasonal/smooth', options)
+        .then(({ job }) => api.waitForJob(job)),
 
     /**
      * Lisse les courbes de température pour un mois donné.
      * @param {number} monthIndex - L'index du mois (0-11).
-     * @returns {Promise<Response>} La réponse du serveur.
+     * @returns {Promise<object>} L'état final du travail { job, state }.
      */
-    smoothMonthData: (monthIndex) => postJson('/smoothMonthData', { month: monthIndex }),
+    smoothMonthData: (monthIndex) => api.smoothSeasonalData({ month: monthIndex }),
 
     /**
-     * Sauvegarde l'intégralité des données de température annuelles.
-     * @param {Array<Array<number>>} yearlyData - Le tableau 2D des températures annuelles (jour x heure).
-     * @returns {Promise<Response>} La réponse du serveur.
+     * Recopie cycliquement les jours d'un mois sur une plage de jours.
+     * @param {number} monthIndex - Le mois source (0-11).
+     * @param {number} from - Premier jour de destination (0-365).
+     * @param {number} to - Dernier jour de destination (peut précéder from : passage par le 31/12).
+     * @returns {Promise<object>} L'état final du travail { job, state }.
+     */
+    extendMonthData: (monthIndex, from, to) => postJson('/api/seasonal/extend', { month: monthIndex, from, to })
+        .then(({ job }) => api.waitForJob(job)),
+
+    /**
+     * Envoie des jours au format de temperature.bin (int16 little-endian, dixièmes de °C).
+     * @param {ArrayBuffer|Int16Array} data - Un ou plusieurs jours de 24 températures.
+     * @param {number} firstDay - Index du premier jour remplacé (0-365).
+     * @returns {Promise<string>} Le message du serveur.
      */
-    saveYearlyTemperatures: (yearlyData) => postJson('/saveYearlyTemperatures', { yearlyData: yearlyData })
-};
\ No newline at end of file
+    uploadSeasonalData: (data, firstDay = 0) => fetch(`/api/seasonal/upload?day=${firstDay}`, {
+        method: 'POST',
+        headers: {
+            'Content-Type': 'application/octet-stream'
+        },
+        body: data
+    }).then(res => {
+        if (!res.ok) throw new Error(`HTTP error! status: ${res.status}`);
+        return res.text();
+    }),
+
+    /**
+     * Sauvegarde l'intégralité des données de température annuelles en une requête.
+     * @param {Array<Array<number>>} yearlyData - Le tableau 2D des températures annuelles en °C (jour x heure).
+     * @returns {Promise<string>} Le message du serveur.
+     */
+    saveYearlyTemperatures: (yearlyData) => {
+        const packed = new Int16Array(yearlyData.length * 24);
+        yearlyData.forEach((day, d) => day.forEach((t, h) => { packed[d * 24 + h] = Math.round(t * 10); }));
+        return api.uploadSeasonalData(packed.buffer, 0);
+    }
+};
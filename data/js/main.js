@@ -7,7 +7,7 @@
 import { state, updateStatus, setConfig } from './state.js';
 import { api } from './api.js';
 import { initTabs } from './ui/tabs.js';
-import { updateSurveillance } from './ui/surveillance.js';
+import { updateSurveillance, loadTrend } from './ui/surveillance.js';
 import { initCamera } from './ui/camera.js';
 import { initConfiguration } from './ui/configuration.js';
 import { initProfiles } from './ui/profiles.js';
@@ -27,6 +27,43 @@ async function periodicUpdate() {
     }
 }
 
+// Interrogation de /api/status, seulement quand le canal SSE est coupé
+let pollTimer = null;
+
+function startPolling() {
+    if (!pollTimer) pollTimer = setInterval(periodicUpdate, 2000);
+}
+
+function stopPolling() {
+    clearInterval(pollTimer);
+    pollTimer = null;
+}
+
+function startLiveUpdates() {
+    if (!window.EventSource) {
+        startPolling();
+        return;
+    }
+    api.openStatusEvents({
+        // Les deltas ne contiennent que les champs modifiés
+        status: (delta) => {
+            updateStatus({ ...state.status, ...delta });
+            updateSurveillance(state.status);
+        },
+        safety: (event) => {
+            Object.assign(state.status, {
+                safetyLevel: event.level,
+                safety_message: event.message,
+                emergencyShutdown: event.emergencyShutdown
+            });
+            if (event.level > 0) console.warn(`Sécurité niveau ${event.level}: ${event.message}`);
+        },
+        open: stopPolling,
+        // EventSource se reconnecte seul ; on interroge en attendant
+        error: startPolling
+    });
+}
+
 // --- INITIALISATION ---
 
 document.addEventListener('DOMContentLoaded', async () => {
@@ -82,9 +119,11 @@ document.addEventListener('DOMContentLoaded', async () => {
             }
         });
 
-        // 3. Démarrer les mises à jour périodiques
-        setInterval(periodicUpdate, 2000); // Toutes les 2 secondes
-        await periodicUpdate(); // Premier appel immédiat
+        // 3. Démarrer les mises à jour : statut complet, puis deltas poussés par le serveur
+        await periodicUpdate();
+        startLiveUpdates();
+        setInterval(loadTrend, 3600000); // Agrégats journaliers : une fois par heure
+        loadTrend();
 
         console.log("✅ Application initialisée avec succès.");
 
@@ -4,6 +4,7 @@
  */
 
 import { state } from '../state.js';
+import { api } from '../api.js';
 
 // Références aux éléments du DOM
 const elements = {
@@ -22,10 +23,11 @@ const elements = {
     ledDot: document.getElementById('led-dot'),
     currentTime: document.getElementById('currentTime'),
     tempChartCanvas: document.getElementById('tempChart'),
-    humidityChartCanvas: document.getElementById('humidityChart')
+    humidityChartCanvas: document.getElementById('humidityChart'),
+    trendChartCanvas: document.getElementById('trendChart')
 };
 
-let tempChart, humidityChart;
+let tempChart, humidityChart, trendChart;
 
 function createChart(canvas, label, color) {
     if (!canvas) return null;
@@ -59,6 +61,30 @@ function createChart(canvas, label, color) {
 export function initSurveillance() {
     tempChart = createChart(elements.tempChartCanvas, 'Température', '#ff6b6b');
     humidityChart = createChart(elements.humidityChartCanvas, 'Humidité', '#4dabf7');
+    trendChart = createChart(elements.trendChartCanvas, 'Moyenne', '#ff6b6b');
+    if (trendChart) {
+        trendChart.data.datasets.push(
+            { label: 'Min', data: [], borderColor: '#4dabf7', borderWidth: 1, fill: false, pointRadius: 0 },
+            { label: 'Max', data: [], borderColor: '#f59f00', borderWidth: 1, fill: false, pointRadius: 0 }
+        );
+    }
+}
+
+/**
+ * Charge les agrégats journaliers (un point par jour, 365 au plus) dans le graphique de tendance.
+ */
+export async function loadTrend() {
+    if (!trendChart) return;
+    try {
+        const days = await api.getHistoryRollup('day', 365);
+        trendChart.data.labels = days.map(d => new Date(d.t * 1000).toLocaleDateString());
+        trendChart.data.datasets[0].data = days.map(d => d.tavg / 10.0);
+        trendChart.data.datasets[1].data = days.map(d => d.tmin / 10.0);
+        trendChart.data.datasets[2].data = days.map(d => d.tmax / 10.0);
+        trendChart.update('none');
+    } catch (error) {
+        console.error("Erreur lors du chargement de la tendance:", error);
+    }
 }
 
 function calculateStats(data) {
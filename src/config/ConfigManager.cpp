@@ -6,6 +6,7 @@
 Preferences ConfigManager::prefs;
 unsigned long ConfigManager::lastSaveRequest = 0;
 bool ConfigManager::savePending = false;
+std::atomic<uint32_t> ConfigManager::dirtyFields{0};
 
 // Define a version for the preferences data structure
 // Increment this if the structure of SystemConfig changes significantly
@@ -51,6 +52,8 @@ bool ConfigManager::loadConfig(SystemConfig& config) {
     config.currentProfileName = prefs.getString("currentProfile", "default"); // Correctly load String
     config.cameraEnabled = prefs.getBool("cameraEnabled", config.cameraEnabled);
     config.cameraResolution = prefs.getString("cameraRes", config.cameraResolution); // Correctly load String
+    config.motionRecording = prefs.getBool("motionRec", config.motionRecording);
+    config.timelapseMinutes = prefs.getUShort("tlMinutes", config.timelapseMinutes);
     config.useTempCurve = prefs.getBool("useTempCurve", config.useTempCurve);
     config.useLimitTemp = prefs.getBool("useLimitTemp", config.useLimitTemp);
     config.logLevel = prefs.getUChar("logLevel", config.logLevel);
@@ -104,35 +107,7 @@ bool ConfigManager::saveConfig(const SystemConfig& config) {
     prefs.putUInt("prefsVersion", PREFS_VERSION); // Always save current version
 
     // Save individual members
-    prefs.putBool("usePWM", config.usePWM);
-    prefs.putBool("weatherMode", config.weatherModeEnabled);
-    prefs.putString("currentProfile", config.currentProfileName); // Correctly save String
-    prefs.putBool("cameraEnabled", config.cameraEnabled);
-    prefs.putString("cameraRes", config.cameraResolution); // Correctly save String
-    prefs.putBool("useTempCurve", config.useTempCurve);
-    prefs.putBool("useLimitTemp", config.useLimitTemp);
-    
-    prefs.putFloat("hysteresis", config.hysteresis);
-    prefs.putFloat("Kp", config.Kp);
-    prefs.putFloat("Ki", config.Ki);
-    prefs.putFloat("Kd", config.Kd);
-    
-    prefs.putShort("setpoint", config.setpoint);
-    prefs.putShort("minTemp", config.globalMinTempSet);
-    prefs.putShort("maxTemp", config.globalMaxTempSet);
-    
-    // Save tempCurve array
-    prefs.putBytes("tempCurve", config.tempCurve, sizeof(config.tempCurve));
-
-    prefs.putFloat("latitude", config.latitude);
-    prefs.putFloat("longitude", config.longitude);
-    prefs.putInt("DST_offset", config.DST_offset);
-    
-    prefs.putBool("ledState", config.ledState);
-    prefs.putUChar("ledBright", config.ledBrightness);
-    prefs.putUChar("ledRed", config.ledRed);
-    prefs.putUChar("ledGreen", config.ledGreen);
-    prefs.putUChar("ledBlue", config.ledBlue);
+    writeFields(config, CFG_ALL_FIELDS);
     
     prefs.putUInt("configVersion", config.configVersion);
     // Hash is calculated and stored in config object, then saved
@@ -147,17 +122,69 @@ bool ConfigManager::saveConfig(const SystemConfig& config) {
         prefs.putString("lastSave", "unknown");
     }
     
-    prefs.putUChar("logLevel", config.logLevel);
     prefs.end();
     return true;
 }
 
+void ConfigManager::writeFields(const SystemConfig& config, uint32_t fields) {
+    // prefs doit être ouvert en écriture
+    if (fields & CFG_USE_PWM) prefs.putBool("usePWM", config.usePWM);
+    if (fields & CFG_WEATHER_MODE) prefs.putBool("weatherMode", config.weatherModeEnabled);
+    if (fields & CFG_PROFILE_NAME) prefs.putString("currentProfile", config.currentProfileName);
+    if (fields & CFG_CAMERA_ENABLED) prefs.putBool("cameraEnabled", config.cameraEnabled);
+    if (fields & CFG_CAMERA_RES) prefs.putString("cameraRes", config.cameraResolution);
+    if (fields & CFG_MOTION_RECORDING) prefs.putBool("motionRec", config.motionRecording);
+    if (fields & CFG_TIMELAPSE) prefs.putUShort("tlMinutes", config.timelapseMinutes);
+    if (fields & CFG_USE_TEMP_CURVE) prefs.putBool("useTempCurve", config.useTempCurve);
+    if (fields & CFG_USE_LIMIT_TEMP) prefs.putBool("useLimitTemp", config.useLimitTemp);
+
+    if (fields & CFG_HYSTERESIS) prefs.putFloat("hysteresis", config.hysteresis);
+    if (fields & CFG_KP) prefs.putFloat("Kp", config.Kp);
+    if (fields & CFG_KI) prefs.putFloat("Ki", config.Ki);
+    if (fields & CFG_KD) prefs.putFloat("Kd", config.Kd);
+
+    if (fields & CFG_SETPOINT) prefs.putShort("setpoint", config.setpoint);
+    if (fields & CFG_MIN_TEMP) prefs.putShort("minTemp", config.globalMinTempSet);
+    if (fields & CFG_MAX_TEMP) prefs.putShort("maxTemp", config.globalMaxTempSet);
+    if (fields & CFG_TEMP_CURVE) prefs.putBytes("tempCurve", config.tempCurve, sizeof(config.tempCurve));
+
+    if (fields & CFG_LATITUDE) prefs.putFloat("latitude", config.latitude);
+    if (fields & CFG_LONGITUDE) prefs.putFloat("longitude", config.longitude);
+    if (fields & CFG_DST_OFFSET) prefs.putInt("DST_offset", config.DST_offset);
+
+    if (fields & CFG_LED_STATE) prefs.putBool("ledState", config.ledState);
+    if (fields & CFG_LED_BRIGHTNESS) prefs.putUChar("ledBright", config.ledBrightness);
+    if (fields & CFG_LED_RED) prefs.putUChar("ledRed", config.ledRed);
+    if (fields & CFG_LED_GREEN) prefs.putUChar("ledGreen", config.ledGreen);
+    if (fields & CFG_LED_BLUE) prefs.putUChar("ledBlue", config.ledBlue);
+
+    if (fields & CFG_LOG_LEVEL) prefs.putUChar("logLevel", config.logLevel);
+}
+
+bool ConfigManager::saveFields(SystemConfig& config, uint32_t fields) {
+    if (!config.isValid()) {
+        LOG_ERROR("CONFIG", "Configuration invalide, sauvegarde annulée");
+        return false;
+    }
+    // Seules les clés modifiées et le hash sont réécrits ; lastSave n'est
+    // mis à jour que par une sauvegarde complète.
+    config.configHash = calculateConfigHash(config);
+    prefs.begin("system", false);
+    writeFields(config, fields);
+    prefs.putUInt("configHash", config.configHash);
+    prefs.end();
+    LOG_INFO("CONFIG", "Sauvegarde partielle (champs 0x%06lx)", (unsigned long)fields);
+    return true;
+}
+
 uint32_t ConfigManager::calculateConfigHash(const SystemConfig& config) {
     uint32_t hash = 0;
     // Hash relevant members individually
     hash = hash * 31 + (uint32_t)config.usePWM;
     hash = hash * 31 + (uint32_t)config.weatherModeEnabled;
     hash = hash * 31 + (uint32_t)config.cameraEnabled;
+    hash = hash * 31 + (uint32_t)config.motionRecording;
+    hash = hash * 31 + (uint32_t)config.timelapseMinutes;
     hash = hash * 31 + (uint32_t)config.useTempCurve;
     hash = hash * 31 + (uint32_t)config.useLimitTemp;
     hash = hash * 31 + (uint32_t)(config.hysteresis * 1000); // Convert float to int for hashing
@@ -198,7 +225,8 @@ uint32_t ConfigManager::calculateConfigHash(const SystemConfig& config) {
     return hash;
 }
 
-void ConfigManager::requestSave() {
+void ConfigManager::requestSave(uint32_t fields) {
+    dirtyFields.fetch_or(fields);
     lastSaveRequest = millis();
     savePending = true;
 }
@@ -218,7 +246,12 @@ bool ConfigManager::saveConfigIfChanged(SystemConfig& config) {
 void ConfigManager::processPendingSave(SystemConfig& config) {
     if (savePending && (millis() - lastSaveRequest >= SAVE_DELAY)) {
         savePending = false;
-        saveConfigIfChanged(config);
+        uint32_t fields = dirtyFields.exchange(0);
+        if (fields == CFG_ALL_FIELDS) {
+            saveConfigIfChanged(config);
+        } else if (fields != 0) {
+            saveFields(config, fields);
+        }
     }
 }
 
@@ -237,6 +270,8 @@ bool ConfigManager::createDefaultProfile() {
     doc["weatherModeEnabled"] = false;
     doc["cameraEnabled"] = false;
     doc["cameraResolution"] = "qvga";
+    doc["motionRecording"] = false;
+    doc["timelapseMinutes"] = 0;
     doc["useTempCurve"] = false;
     doc["useLimitTemp"] = true;
     doc["hysteresis"] = 0.3;
@@ -274,6 +309,8 @@ bool ConfigManager::saveProfile(const String& profileName, const SystemConfig& c
     doc["weatherModeEnabled"] = config.weatherModeEnabled;
     doc["cameraEnabled"] = config.cameraEnabled;
     doc["cameraResolution"] = config.cameraResolution;
+    doc["motionRecording"] = config.motionRecording;
+    doc["timelapseMinutes"] = config.timelapseMinutes;
     doc["useTempCurve"] = config.useTempCurve;
     doc["useLimitTemp"] = config.useLimitTemp;
     doc["hysteresis"] = config.hysteresis;
@@ -317,6 +354,8 @@ bool ConfigManager::loadProfile(const String& profileName, SystemConfig& config)
     if (doc.containsKey("weatherModeEnabled")) config.weatherModeEnabled = doc["weatherModeEnabled"];
     if (doc.containsKey("cameraEnabled")) config.cameraEnabled = doc["cameraEnabled"];
     if (doc.containsKey("cameraResolution")) config.cameraResolution = doc["cameraResolution"].as<String>();
+    if (doc.containsKey("motionRecording")) config.motionRecording = doc["motionRecording"];
+    if (doc.containsKey("timelapseMinutes")) config.timelapseMinutes = min(doc["timelapseMinutes"].as<unsigned>(), (unsigned)TimelapseConstants::MAX_INTERVAL_MINUTES);
     if (doc.containsKey("useTempCurve")) config.useTempCurve = doc["useTempCurve"];
     if (doc.containsKey("useLimitTemp")) config.useLimitTemp = doc["useLimitTemp"];
     if (doc.containsKey("hysteresis")) config.hysteresis = doc["hysteresis"];
@@ -409,6 +448,67 @@ bool ConfigManager::saveSeasonalData(const String& profileName, int dayIndex, co
     return (bytesWritten == 24 * sizeof(int16_t));
 }
 
+bool ConfigManager::writeSeasonalDays(const String& profileName, int firstDay, const uint8_t* data, int dayCount) {
+    using namespace SeasonalConstants;
+    if (firstDay < 0 || dayCount <= 0 || firstDay + dayCount > DAYS) return false;
+    if (!ensureProfileDirectory(profileName)) return false;
+    const String tempPath = "/profiles/" + profileName + "/temperature.bin";
+    const String newPath = tempPath + ".tmp";
+
+    File target = LittleFS.open(newPath, "w");
+    if (!target) return false;
+    // Jours hors de la plage : repris de l'ancien fichier, ou par défaut s'il manque
+    File source;
+    if (dayCount < DAYS) source = LittleFS.open(tempPath, "r");
+
+    bool ok = true;
+    int16_t kept[HOURS];
+    for (int day = 0; day < DAYS && ok; day++) {
+        if (day == firstDay) {
+            size_t bytes = dayCount * DAY_BYTES;
+            ok = target.write(data, bytes) == bytes;
+            day += dayCount - 1;
+            continue;
+        }
+        if (!source || !source.seek(day * DAY_BYTES) || source.read((uint8_t*)kept, DAY_BYTES) != DAY_BYTES) {
+            generateDefaultDayTemperatures(day, kept);
+        }
+        ok = target.write((uint8_t*)kept, DAY_BYTES) == DAY_BYTES;
+    }
+    if (source) source.close();
+    target.close();
+
+    if (!ok || !LittleFS.rename(newPath, tempPath)) {
+        LOG_ERROR("CONFIG", "Échec de l'écriture de %s", tempPath.c_str());
+        LittleFS.remove(newPath);
+        return false;
+    }
+    LOG_INFO("CONFIG", "temperature.bin : jours %d à %d remplacés", firstDay, firstDay + dayCount - 1);
+    return true;
+}
+
+bool ConfigManager::readSeasonalYear(const String& profileName, int16_t* year) {
+    const String tempPath = "/profiles/" + profileName + "/temperature.bin";
+    File file = LittleFS.open(tempPath, "r");
+    if (!file) return false;
+    size_t bytesRead = file.read((uint8_t*)year, SeasonalConstants::FILE_BYTES);
+    file.close();
+    return bytesRead == SeasonalConstants::FILE_BYTES;
+}
+
+bool ConfigManager::applyCurveToYear(const String& profileName, const int16_t* curve) {
+    using namespace SeasonalConstants;
+    int16_t* year = (int16_t*)ps_malloc(FILE_BYTES);
+    if (!year) year = (int16_t*)malloc(FILE_BYTES);
+    if (!year) return false;
+    for (int day = 0; day < DAYS; day++) {
+        memcpy(year + day * HOURS, curve, DAY_BYTES);
+    }
+    bool ok = writeSeasonalDays(profileName, 0, (const uint8_t*)year, DAYS);
+    free(year);
+    return ok;
+}
+
 bool ConfigManager::createDefaultSeasonalData(const String& profileName) {
     if (!ensureProfileDirectory(profileName)) return false;
     const String tempPath = "/profiles/" + profileName + "/temperature.bin";
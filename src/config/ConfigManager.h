@@ -6,6 +6,7 @@
 #include <LittleFS.h>
 #include <ArduinoJson.h>
 #include <vector>
+#include <atomic>
 
 // La classe ConfigManager gère la configuration du système.
 // Elle est conçue comme une classe statique pour un accès simple et direct.
@@ -40,8 +41,10 @@ public:
 
     /**
      * @brief Demande une sauvegarde différée de la configuration.
+     * @param fields Les champs modifiés (ConfigField) ; par défaut, tous.
+     * Les demandes successives s'accumulent jusqu'à la sauvegarde.
      */
-    static void requestSave();
+    static void requestSave(uint32_t fields = CFG_ALL_FIELDS);
 
     /**
      * @brief Traite les demandes de sauvegarde différée.
@@ -113,6 +116,36 @@ public:
      */
     static bool saveSeasonalData(const String& profileName, int dayIndex, const int16_t* temperatures);
 
+    /**
+     * @brief Remplace une plage de jours de temperature.bin en une seule écriture
+     * séquentielle : le fichier est réécrit à côté puis renommé par-dessus
+     * l'ancien, un lecteur voit donc l'ancienne ou la nouvelle année, jamais un mélange.
+     * @param profileName Nom du profil.
+     * @param firstDay Premier jour remplacé (0-365).
+     * @param data dayCount × 24 températures int16 little-endian (dixièmes de °C).
+     * @param dayCount Nombre de jours remplacés.
+     * @return true si le nouveau fichier est en place, false sinon (ancien fichier intact).
+     */
+    static bool writeSeasonalDays(const String& profileName, int firstDay, const uint8_t* data, int dayCount);
+
+    /**
+     * @brief Lit tout temperature.bin en une seule lecture.
+     * @param profileName Nom du profil.
+     * @param year Tampon de SeasonalConstants::FILE_BYTES octets.
+     * @return true si l'année complète a été lue, false sinon.
+     */
+    static bool readSeasonalYear(const String& profileName, int16_t* year);
+
+    /**
+     * @brief Applique une même courbe de 24 h à toute l'année : le fichier
+     * est construit en mémoire (PSRAM si possible) puis écrit d'un seul
+     * tenant par writeSeasonalDays(). Opération longue : hors des gestionnaires web.
+     * @param profileName Nom du profil.
+     * @param curve 24 températures en dixièmes de °C.
+     * @return true si l'année a été réécrite, false sinon.
+     */
+    static bool applyCurveToYear(const String& profileName, const int16_t* curve);
+
     /**
      * @brief Crée un fichier de données saisonnières par défaut pour un profil.
      * @param profileName Nom du profil.
@@ -124,9 +157,12 @@ private:
     static Preferences prefs;
     static unsigned long lastSaveRequest;
     static bool savePending;
+    static std::atomic<uint32_t> dirtyFields;   // ConfigField en attente de sauvegarde
     static const unsigned long SAVE_DELAY = 5000;
     
     static uint32_t calculateConfigHash(const SystemConfig& config);
+    static void writeFields(const SystemConfig& config, uint32_t fields);
+    static bool saveFields(SystemConfig& config, uint32_t fields);
     static bool ensureProfileDirectory(const String& profileName);
     static void generateDefaultDayTemperatures(int dayIndex, int16_t* dayTemps);
 };
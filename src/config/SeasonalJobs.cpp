@@ -0,0 +1,133 @@
+#include "SeasonalJobs.h"
+#include "ConfigManager.h"
+#include "../utils/Logger.h"
+
+SeasonalJobs::Job SeasonalJobs::job;
+SeasonalJobs::State SeasonalJobs::state = JOB_UNKNOWN;
+uint32_t SeasonalJobs::lastId = 0;
+portMUX_TYPE SeasonalJobs::jobMux = portMUX_INITIALIZER_UNLOCKED;
+
+uint32_t SeasonalJobs::applyCurve(const String& profileName, const int16_t* curve) {
+    Job* next = reserve(APPLY_CURVE, profileName);
+    if (!next) return 0;
+    memcpy(next->curve, curve, sizeof(next->curve));
+    uint32_t id = next->id;
+    start();
+    return id;
+}
+
+uint32_t SeasonalJobs::smooth(const String& profileName, const SeasonalKernels::SmoothParams& params) {
+    Job* next = reserve(SMOOTH, profileName);
+    if (!next) return 0;
+    next->smooth = params;
+    uint32_t id = next->id;
+    start();
+    return id;
+}
+
+uint32_t SeasonalJobs::extend(const String& profileName, int sourceFirst, int sourceLast, int firstDay, int lastDay) {
+    Job* next = reserve(EXTEND, profileName);
+    if (!next) return 0;
+    next->sourceFirst = sourceFirst;
+    next->sourceLast = sourceLast;
+    next->firstDay = firstDay;
+    next->lastDay = lastDay;
+    uint32_t id = next->id;
+    start();
+    return id;
+}
+
+SeasonalJobs::State SeasonalJobs::getState(uint32_t id) {
+    portENTER_CRITICAL(&jobMux);
+    State current = (id != 0 && id == lastId) ? state : JOB_UNKNOWN;
+    portEXIT_CRITICAL(&jobMux);
+    return current;
+}
+
+bool SeasonalJobs::isRunning() {
+    portENTER_CRITICAL(&jobMux);
+    bool running = state == JOB_RUNNING;
+    portEXIT_CRITICAL(&jobMux);
+    return running;
+}
+
+const char* SeasonalJobs::stateName(State state) {
+    switch (state) {
+        case JOB_RUNNING: return "running";
+        case JOB_DONE: return "done";
+        case JOB_FAILED: return "failed";
+        default: return "unknown";
+    }
+}
+
+SeasonalJobs::Job* SeasonalJobs::reserve(Kind kind, const String& profileName) {
+    // Le travail en cours garde ses paramètres : refus plutôt que file d'attente
+    portENTER_CRITICAL(&jobMux);
+    if (state == JOB_RUNNING) {
+        portEXIT_CRITICAL(&jobMux);
+        return nullptr;
+    }
+    state = JOB_RUNNING;
+    job.id = ++lastId;
+    portEXIT_CRITICAL(&jobMux);
+
+    job.kind = kind;
+    strlcpy(job.profileName, profileName.c_str(), sizeof(job.profileName));
+    return &job;
+}
+
+void SeasonalJobs::start() {
+    TaskHandle_t task = NULL;
+    xTaskCreatePinnedToCore(jobLoop, "SeasonalJob", 4096, NULL, 1, &task, 0);
+    if (task == NULL) {
+        LOG_WARN("SEASONAL", "Tâche de fond indisponible, travail %lu exécuté sur place", (unsigned long)job.id);
+        execute();
+    }
+}
+
+void SeasonalJobs::jobLoop(void* arg) {
+    execute();
+    vTaskDelete(NULL);
+}
+
+void SeasonalJobs::execute() {
+    unsigned long startTime = millis();
+    bool ok = run(job);
+    LOG_INFO("SEASONAL", "Travail %lu %s en %lu ms", (unsigned long)job.id, ok ? "terminé" : "en échec", millis() - startTime);
+
+    portENTER_CRITICAL(&jobMux);
+    state = ok ? JOB_DONE : JOB_FAILED;
+    portEXIT_CRITICAL(&jobMux);
+}
+
+bool SeasonalJobs::run(const Job& work) {
+    switch (work.kind) {
+        case APPLY_CURVE:
+            return ConfigManager::applyCurveToYear(work.profileName, work.curve);
+        case SMOOTH:
+        case EXTEND:
+            return transformYear(work);
+    }
+    return false;
+}
+
+bool SeasonalJobs::transformYear(const Job& work) {
+    // Lecture, calcul et écriture de l'année entière, chacun d'un seul tenant
+    int16_t* year = (int16_t*)ps_malloc(SeasonalConstants::FILE_BYTES);
+    if (!year) year = (int16_t*)malloc(SeasonalConstants::FILE_BYTES);
+    if (!year) return false;
+
+    bool ok = ConfigManager::readSeasonalYear(work.profileName, year);
+    if (ok) {
+        unsigned long startTime = micros();
+        ok = work.kind == SMOOTH
+            ? SeasonalKernels::smooth(year, work.smooth)
+            : SeasonalKernels::extend(year, work.sourceFirst, work.sourceLast, work.firstDay, work.lastDay);
+        LOG_INFO("SEASONAL", "Calcul sur l'année : %lu µs", micros() - startTime);
+    }
+    if (ok) {
+        ok = ConfigManager::writeSeasonalDays(work.profileName, 0, (const uint8_t*)year, SeasonalConstants::DAYS);
+    }
+    free(year);
+    return ok;
+}
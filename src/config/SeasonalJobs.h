@@ -0,0 +1,92 @@
+#ifndef SEASONAL_JOBS_H
+#define SEASONAL_JOBS_H
+
+#include "SystemConfig.h"
+#include "SeasonalKernels.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// La classe SeasonalJobs exécute les traitements de temperature.bin qui
+// portent sur toute l'année (plusieurs centaines de ms d'écriture en flash)
+// dans une tâche de fond, pour ne pas bloquer la tâche AsyncTCP. Un seul
+// travail à la fois : le gestionnaire web répond 202 avec l'identifiant
+// renvoyé, que le client interroge ensuite par getState().
+class SeasonalJobs {
+public:
+    enum State : uint8_t {
+        JOB_UNKNOWN = 0,   // Identifiant inconnu ou remplacé par un travail plus récent
+        JOB_RUNNING,
+        JOB_DONE,
+        JOB_FAILED
+    };
+
+    /**
+     * @brief Lance l'application d'une courbe de 24 h à toute l'année.
+     * @param profileName Nom du profil.
+     * @param curve 24 températures en dixièmes de °C.
+     * @return L'identifiant du travail, 0 si un travail est déjà en cours.
+     */
+    static uint32_t applyCurve(const String& profileName, const int16_t* curve);
+
+    /**
+     * @brief Lance le lissage de l'année (voir SeasonalKernels::smooth).
+     * @return L'identifiant du travail, 0 si un travail est déjà en cours.
+     */
+    static uint32_t smooth(const String& profileName, const SeasonalKernels::SmoothParams& params);
+
+    /**
+     * @brief Lance la recopie cyclique des jours [sourceFirst, sourceLast]
+     * sur [firstDay, lastDay] (voir SeasonalKernels::extend).
+     * @return L'identifiant du travail, 0 si un travail est déjà en cours.
+     */
+    static uint32_t extend(const String& profileName, int sourceFirst, int sourceLast, int firstDay, int lastDay);
+
+    /**
+     * @brief Indique si un travail est en cours. Les autres écritures de
+     * temperature.bin (import, sauvegarde de jours) sont alors refusées :
+     * elles passeraient par le même fichier .tmp, ou seraient écrasées par
+     * le renommage final du travail. Les travaux ne sont lancés que depuis
+     * la tâche AsyncTCP : un test suivi d'une écriture dans le même
+     * gestionnaire ne peut pas croiser un nouveau lancement.
+     */
+    static bool isRunning();
+
+    /**
+     * @brief Renvoie l'état d'un travail (seul le dernier est conservé).
+     */
+    static State getState(uint32_t id);
+
+    static const char* stateName(State state);
+
+private:
+    enum Kind : uint8_t {
+        APPLY_CURVE,
+        SMOOTH,
+        EXTEND
+    };
+
+    // Paramètres copiés au lancement : la requête web n'existe plus pendant l'exécution
+    struct Job {
+        uint32_t id;
+        Kind kind;
+        char profileName[32];
+        int16_t curve[SeasonalConstants::HOURS];      // APPLY_CURVE
+        SeasonalKernels::SmoothParams smooth;          // SMOOTH
+        int16_t sourceFirst, sourceLast;               // EXTEND : source...
+        int16_t firstDay, lastDay;                     // ...recopiée sur cette plage
+    };
+
+    static Job job;
+    static State state;
+    static uint32_t lastId;
+    static portMUX_TYPE jobMux;
+
+    static Job* reserve(Kind kind, const String& profileName);
+    static void start();
+    static void jobLoop(void* arg);
+    static void execute();
+    static bool run(const Job& work);
+    static bool transformYear(const Job& work);
+};
+
+#endif // SEASONAL_JOBS_H
@@ -0,0 +1,105 @@
+#include "SeasonalKernels.h"
+#include <math.h>
+
+using namespace SeasonalConstants;
+
+namespace {
+    // Premier jour de chaque mois d'une année bissextile (temperature.bin a 366 jours)
+    const int16_t MONTH_START[13] = { 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366 };
+    const int YEAR_HOURS = DAYS * HOURS;
+
+    inline int wrap(int value, int period) {
+        value %= period;
+        return value < 0 ? value + period : value;
+    }
+
+    void* allocate(size_t bytes) {
+        void* buffer = ps_malloc(bytes);
+        return buffer ? buffer : malloc(bytes);
+    }
+}
+
+void SeasonalKernels::monthRange(int month, int& firstDay, int& lastDay) {
+    month = wrap(month, 12);
+    firstDay = MONTH_START[month];
+    lastDay = MONTH_START[month + 1] - 1;
+}
+
+int SeasonalKernels::rangeLength(int firstDay, int lastDay) {
+    if (firstDay < 0 || firstDay >= DAYS || lastDay < 0 || lastDay >= DAYS) return 0;
+    return wrap(lastDay - firstDay, DAYS) + 1;
+}
+
+int SeasonalKernels::buildWeights(Kernel kernel, uint8_t radius, float* weights) {
+    if (radius == 0) {
+        weights[0] = 1.0f;
+        return 1;
+    }
+    float sum = 0.0f;
+    float sigma = radius / 2.0f;
+    for (int k = -radius; k <= radius; k++) {
+        float w = kernel == KERNEL_GAUSSIAN ? expf(-(k * k) / (2.0f * sigma * sigma)) : 1.0f;
+        weights[k + radius] = w;
+        sum += w;
+    }
+    for (int i = 0; i <= 2 * radius; i++) weights[i] /= sum;
+    return 2 * radius + 1;
+}
+
+bool SeasonalKernels::smooth(int16_t* year, const SmoothParams& params) {
+    int length = rangeLength(params.firstDay, params.lastDay);
+    if (length == 0 || params.dayRadius > MAX_DAY_RADIUS || params.hourRadius > MAX_HOUR_RADIUS) return false;
+    if (params.dayRadius == 0 && params.hourRadius == 0) return true;
+
+    float* pass = (float*)allocate(YEAR_HOURS * sizeof(float));
+    if (!pass) return false;
+    float dayWeights[2 * MAX_DAY_RADIUS + 1];
+    float hourWeights[2 * MAX_HOUR_RADIUS + 1];
+    int dayTaps = buildWeights(params.kernel, params.dayRadius, dayWeights);
+    int hourTaps = buildWeights(params.kernel, params.hourRadius, hourWeights);
+
+    // 1) Entre jours, à heure égale, sur toute l'année : la seconde passe lit
+    //    aussi les heures des jours voisins de la plage
+    for (int day = 0; day < DAYS; day++) {
+        for (int hour = 0; hour < HOURS; hour++) {
+            float sum = 0.0f;
+            for (int k = 0; k < dayTaps; k++) {
+                int source = wrap(day + k - params.dayRadius, DAYS);
+                sum += dayWeights[k] * year[source * HOURS + hour];
+            }
+            pass[day * HOURS + hour] = sum;
+        }
+    }
+
+    // 2) Le long de la série horaire, pour les seuls jours de la plage
+    for (int i = 0; i < length; i++) {
+        int day = (params.firstDay + i) % DAYS;
+        for (int hour = 0; hour < HOURS; hour++) {
+            int index = day * HOURS + hour;
+            float sum = 0.0f;
+            for (int k = 0; k < hourTaps; k++) {
+                sum += hourWeights[k] * pass[wrap(index + k - params.hourRadius, YEAR_HOURS)];
+            }
+            year[index] = (int16_t)lroundf(sum);
+        }
+    }
+    free(pass);
+    return true;
+}
+
+bool SeasonalKernels::extend(int16_t* year, int sourceFirst, int sourceLast, int firstDay, int lastDay) {
+    int sourceLength = rangeLength(sourceFirst, sourceLast);
+    int length = rangeLength(firstDay, lastDay);
+    if (sourceLength == 0 || length == 0) return false;
+
+    int16_t* source = (int16_t*)allocate(sourceLength * DAY_BYTES);
+    if (!source) return false;
+    for (int i = 0; i < sourceLength; i++) {
+        memcpy(source + i * HOURS, year + ((sourceFirst + i) % DAYS) * HOURS, DAY_BYTES);
+    }
+    for (int i = 0; i < length; i++) {
+        memcpy(year + ((firstDay + i) % DAYS) * HOURS, source + (i % sourceLength) * HOURS, DAY_BYTES);
+    }
+    free(source);
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef SEASONAL_KERNELS_H
+#define SEASONAL_KERNELS_H
+
+#include "SystemConfig.h"
+
+// Traitements de l'année saisonnière en mémoire : DAYS x HOURS int16 en
+// dixièmes de °C, dans l'ordre de temperature.bin. L'année est vue comme
+// circulaire : le 31/12 précède le 1/1, et la 23e heure d'un jour précède la
+// première du lendemain, il n'y a donc pas de raccord au bord de l'année.
+class SeasonalKernels {
+public:
+    enum Kernel : uint8_t {
+        KERNEL_BOX,        // Moyenne glissante
+        KERNEL_GAUSSIAN    // Gaussienne, sigma = rayon / 2
+    };
+
+    struct SmoothParams {
+        Kernel kernel;
+        uint8_t dayRadius;    // Même heure des jours voisins (0 : aucun)
+        uint8_t hourRadius;   // Heures voisines, d'un jour sur l'autre (0 : aucun)
+        int16_t firstDay;     // Jours réécrits ; lastDay < firstDay : la plage
+        int16_t lastDay;      // passe par le 31/12
+    };
+
+    static const uint8_t MAX_DAY_RADIUS = 30;
+    static const uint8_t MAX_HOUR_RADIUS = 12;
+
+    /**
+     * @brief Lisse l'année : d'abord entre jours à heure égale, puis le long
+     * de la série horaire. Seuls les jours de la plage sont modifiés, mais
+     * leurs voisins hors plage participent au calcul.
+     * @param year L'année, modifiée sur place.
+     * @return false si les paramètres sont invalides ou la mémoire manque.
+     */
+    static bool smooth(int16_t* year, const SmoothParams& params);
+
+    /**
+     * @brief Recopie cycliquement les jours [sourceFirst, sourceLast] sur la
+     * plage [firstDay, lastDay] (les deux plages peuvent passer par le 31/12).
+     * Les jours de la source situés dans la destination sont lus avant d'être écrasés.
+     * @param year L'année, modifiée sur place.
+     * @return false si une plage est invalide.
+     */
+    static bool extend(int16_t* year, int sourceFirst, int sourceLast, int firstDay, int lastDay);
+
+    /**
+     * @brief Premier et dernier jour d'un mois (0-11) dans l'année de 366 jours.
+     */
+    static void monthRange(int month, int& firstDay, int& lastDay);
+
+private:
+    static int rangeLength(int firstDay, int lastDay);
+    static int buildWeights(Kernel kernel, uint8_t radius, float* weights);
+};
+
+#endif // SEASONAL_KERNELS_H
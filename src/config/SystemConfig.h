@@ -5,7 +5,7 @@
 
 // === CONSTANTES ===
 const int TEMP_CURVE_POINTS = 24;
-const int MAX_HISTORY_RECORDS = 1440;
+const int MAX_HISTORY_RECORDS = 1440;   // Enregistrements renvoyés par /api/history (24 h)
 
 // === ÉNUMÉRATIONS ===
 enum SafetyLevel {
@@ -21,12 +21,6 @@ struct ExternalWeather {
     float humidity;
 };
 
-struct HistoryRecord {
-    time_t timestamp;
-    float temperature;
-    float humidity;
-};
-
 
 
 // === CONFIGURATION PRINCIPALE ===
@@ -37,6 +31,8 @@ struct SystemConfig {
     String currentProfileName = "default";
     bool cameraEnabled = false;
     String cameraResolution = "qvga";
+    bool motionRecording = false;              // Enregistrement sur détection de mouvement
+    uint16_t timelapseMinutes = 0;             // Intervalle du time-lapse (0 : désactivé)
     bool useTempCurve = false;
     bool useLimitTemp = true;
     
@@ -123,6 +119,39 @@ public:
     }
 };
 
+// === CHAMPS PERSISTÉS ===
+// Un bit par clé NVS de SystemConfig : une modification partielle
+// (PATCH /api/config) ne réécrit que les clés des champs marqués.
+enum ConfigField : uint32_t {
+    CFG_USE_PWM          = 1UL << 0,
+    CFG_WEATHER_MODE     = 1UL << 1,
+    CFG_PROFILE_NAME     = 1UL << 2,
+    CFG_CAMERA_ENABLED   = 1UL << 3,
+    CFG_CAMERA_RES       = 1UL << 4,
+    CFG_USE_TEMP_CURVE   = 1UL << 5,
+    CFG_USE_LIMIT_TEMP   = 1UL << 6,
+    CFG_HYSTERESIS       = 1UL << 7,
+    CFG_KP               = 1UL << 8,
+    CFG_KI               = 1UL << 9,
+    CFG_KD               = 1UL << 10,
+    CFG_SETPOINT         = 1UL << 11,
+    CFG_MIN_TEMP         = 1UL << 12,
+    CFG_MAX_TEMP         = 1UL << 13,
+    CFG_TEMP_CURVE       = 1UL << 14,
+    CFG_LATITUDE         = 1UL << 15,
+    CFG_LONGITUDE        = 1UL << 16,
+    CFG_DST_OFFSET       = 1UL << 17,
+    CFG_LED_STATE        = 1UL << 18,
+    CFG_LED_BRIGHTNESS   = 1UL << 19,
+    CFG_LED_RED          = 1UL << 20,
+    CFG_LED_GREEN        = 1UL << 21,
+    CFG_LED_BLUE         = 1UL << 22,
+    CFG_LOG_LEVEL        = 1UL << 23,
+    CFG_MOTION_RECORDING = 1UL << 24,
+    CFG_TIMELAPSE        = 1UL << 25,
+    CFG_ALL_FIELDS       = (1UL << 26) - 1
+};
+
 // === CONSTANTES DE SÉCURITÉ ===
 namespace SafetyConstants {
     const float TEMP_EMERGENCY_HIGH = 40.0f;
@@ -148,6 +177,122 @@ namespace HardwareConstants {
     const int OLED_ADDR = 0x3C;
 }
 
+// === CONSTANTES DE RÉGULATION ===
+namespace ControlConstants {
+    const uint32_t CONTROL_PERIOD_MS = 2000;      // Période de la boucle capteur -> chauffage
+    const uint32_t PID_SAMPLE_MARGIN_MS = 20;     // Tolérance pour que Compute() ne saute pas de cycle
+    const int CONTROL_TASK_PRIORITY = 5;          // Au-dessus de la tâche principale et d'AsyncTCP
+    const uint32_t CONTROL_TASK_STACK = 6144;
+    const int CONTROL_TASK_CORE = 1;
+    const uint32_t SENSOR_PERIOD_MS = 1000;       // Lecture SHT31 (tâche productrice)
+    const int SENSOR_TASK_PRIORITY = 4;           // Sous la régulation, qui ne lit que la boîte aux lettres
+    const uint32_t SENSOR_TASK_STACK = 4096;
+    const int SENSOR_TASK_CORE = 1;
+}
+
+// === CONSTANTES DE LA CAMÉRA ===
+namespace CameraConstants {
+    const int MAX_STREAM_CLIENTS = 4;             // Flux /mjpeg simultanés (503 au-delà)
+    const int MAX_CAPTURE_CLIENTS = 2;            // Réponses /capture en cours d'envoi (503 au-delà)
+    // Une image au plus par client, ouvert ou fermé avant l'acquittement
+    // (l'admission compte les deux), plus : la dernière image, deux copies en
+    // cours (tâche de capture et snapshot()), la détection et le time-lapse.
+    // La capture trouve donc toujours un emplacement libre.
+    const int FRAME_SLOTS = MAX_STREAM_CLIENTS + MAX_CAPTURE_CLIENTS + 5;
+    const uint32_t FRAME_LINGER_MS = 30000;       // Image gardée après fermeture, le temps que lwIP cesse de la renvoyer
+    const int CAPTURE_TASK_PRIORITY = 2;          // Sous AsyncTCP et la régulation
+    const uint32_t CAPTURE_TASK_STACK = 4096;
+    const int CAPTURE_TASK_CORE = 0;              // Jamais sur le cœur de la régulation
+    const uint32_t FRAME_WAIT_MS = 40;            // Attente max de la première image du flux dans snapshot()
+
+    // Flux adaptatif : qualité JPEG puis résolution, d'après le client le plus lent
+    const uint8_t DEFAULT_TARGET_FPS = 12;
+    const uint8_t MAX_TARGET_FPS = 30;
+    const uint32_t ADAPT_WINDOW_MS = 2000;        // Fenêtre de mesure entre deux décisions
+    const uint16_t DEGRADE_PERMILLE = 800;        // Sous 80 % de la cible : un cran plus bas
+    const uint16_t RECOVER_SEND_PERMILLE = 500;   // Image envoyée en moins de la moitié de son budget...
+    const uint8_t RECOVER_WINDOWS = 3;            // ... pendant 3 fenêtres : un cran plus haut
+    const uint8_t RECOVER_WINDOWS_MAX = 30;       // Attente doublée après une remontée ratée, jusqu'ici
+}
+
+// === CONSTANTES DE DÉTECTION DE MOUVEMENT ===
+namespace MotionConstants {
+    const uint32_t ANALYSIS_INTERVAL_MS = 500;    // Deux analyses par seconde au plus
+    const uint32_t CPU_BUDGET_PERMILLE = 30;      // Part d'un cœur : l'intervalle s'allonge au-delà
+    const int GRID_COLS = 16;                     // Grille de luminance comparée au fond
+    const int GRID_ROWS = 12;
+    const uint8_t CELL_THRESHOLD = 12;            // Écart de luminance (0-255) d'une cellule changée
+    const uint16_t TRIGGER_PERMILLE = 30;         // Part des cellules changées qui déclenche
+    const uint8_t BACKGROUND_SHIFT = 3;           // Fond : moyenne glissante de poids 1/8
+    const uint8_t WARMUP_FRAMES = 4;              // Analyses sans déclenchement après (re)démarrage
+    const uint8_t BURST_FRAMES = 5;               // Images enregistrées par événement
+    const uint32_t BURST_INTERVAL_MS = 300;
+    const uint32_t COOLDOWN_MS = 10000;           // Écart min entre deux événements
+    const uint16_t MAX_EVENTS = 64;
+    const uint32_t MAX_BYTES = 768 * 1024;        // JPEG d'événements conservés sur LittleFS
+    const uint32_t FS_RESERVE_BYTES = 128 * 1024; // Laissés libres pour les profils et l'historique
+    const int TASK_PRIORITY = 1;
+    const uint32_t TASK_STACK = 6144;             // Décodeur JPEG (tjpgd) compris
+    const int TASK_CORE = 0;
+}
+
+// === CONSTANTES DU TIME-LAPSE ===
+namespace TimelapseConstants {
+    const uint16_t MAX_INTERVAL_MINUTES = 1440;
+    const uint8_t STAGING_FRAMES = 4;             // Images copiées en PSRAM en attente d'écriture
+    const uint32_t MAX_BYTES = 1536 * 1024;       // Quota des images sur LittleFS
+    const uint32_t EVICT_TARGET_BYTES = MAX_BYTES - MAX_BYTES / 10;  // Éviction par lots jusqu'ici
+    const uint32_t FS_RESERVE_BYTES = 128 * 1024; // Laissés libres pour les profils et l'historique
+    const uint16_t MAX_DAYS = 62;
+    const int WRITER_PRIORITY = 1;                // Sous la capture et AsyncTCP
+    const uint32_t WRITER_STACK = 4096;
+    const int WRITER_CORE = 0;
+}
+
+// === CONSTANTES DE L'HEURE ===
+namespace TimeConstants {
+    // Fuseau POSIX (signe inversé) : UTC+1 sans heure d'été, comme l'ancien
+    // configTime(3600, 0). Il découpe les jours des cumuls persistés et doit
+    // être fixé avant la relecture de l'historique.
+    const char* const TIME_ZONE = "UTC-1";
+    const char* const NTP_SERVER_1 = "pool.ntp.org";
+    const char* const NTP_SERVER_2 = "time.nist.gov";
+}
+
+// === CONSTANTES D'HISTORIQUE ===
+namespace HistoryConstants {
+    const uint32_t RECORD_INTERVAL_MS = 60000;    // Un enregistrement par minute
+    const uint32_t BLOCK_RECORDS = 60;            // Enregistrements par horodatage absolu (1 h)
+    const uint32_t RETENTION_DAYS = 32;
+    const uint32_t PSRAM_BLOCKS = RETENTION_DAYS * 24;
+    const uint32_t FALLBACK_BLOCKS = 24;          // Sans PSRAM : 24 h en SRAM
+    const uint32_t ROLLUP_HOURS = RETENTION_DAYS * 24;
+    const uint32_t ROLLUP_DAYS = 400;
+    const uint32_t MIN_VALID_TIMESTAMP = 1577836800; // 01/01/2020 : heure non synchronisée avant
+    const uint32_t FLUSH_RECORDS = 15;            // Écriture en flash toutes les 15 minutes
+    const uint32_t SEGMENT_BYTES = 16384;         // Taille de rotation d'un segment (~1,8 jour)
+    const uint32_t MAX_SEGMENTS = 20;             // ~320 Ko de LittleFS, ~32 jours
+    const uint8_t PENDING_RECORDS = 16;           // Mesures tamponnées pendant la relecture
+}
+
+// === CONSTANTES DES DONNÉES SAISONNIÈRES (temperature.bin) ===
+namespace SeasonalConstants {
+    const int DAYS = 366;
+    const int HOURS = 24;
+    const size_t DAY_BYTES = HOURS * sizeof(int16_t);
+    const size_t FILE_BYTES = DAYS * DAY_BYTES;   // 17 568 octets, int16 little-endian
+    const int16_t MIN_TEMP = -400;                // -40,0 °C
+    const int16_t MAX_TEMP = 600;                 // 60,0 °C
+}
+
+// === CONSTANTES DU SERVEUR WEB ===
+namespace WebConstants {
+    const uint32_t EVENT_FULL_STATUS_MS = 30000;  // Statut complet périodique sur /api/events
+    const uint32_t EVENT_RECONNECT_MS = 5000;     // Délai de reconnexion conseillé aux navigateurs
+    const size_t EVENT_MAX_QUEUED = 4;            // Au-delà, les deltas sont regroupés
+    const size_t MAX_BODY_BYTES = 96 * 1024;      // Corps POST assemblé (366 jours en JSON)
+}
+
 // === MACRO DEBUG ===
 
 
@@ -0,0 +1,101 @@
+#include "ControlTask.h"
+#include "../config/SystemConfig.h"
+#include "../utils/Logger.h"
+#include <esp_task_wdt.h>
+
+using namespace ControlConstants;
+
+// Définition des membres statiques
+ControlTask::StepFunction ControlTask::stepFunction = nullptr;
+esp_timer_handle_t ControlTask::timer = nullptr;
+TaskHandle_t ControlTask::taskHandle = NULL;
+portMUX_TYPE ControlTask::statsMux = portMUX_INITIALIZER_UNLOCKED;
+ControlTimingStats ControlTask::stats = {};
+int64_t ControlTask::lastWakeUs = 0;
+
+bool ControlTask::start(StepFunction step, uint32_t periodMs) {
+    if (taskHandle != NULL) {
+        LOG_WARN("CONTROL", "Tâche de régulation déjà démarrée");
+        return false;
+    }
+    stepFunction = step;
+    stats = {};
+    stats.periodUs = periodMs * 1000;
+
+    xTaskCreatePinnedToCore(
+        taskLoop,
+        "Control",
+        CONTROL_TASK_STACK,
+        NULL,
+        CONTROL_TASK_PRIORITY,
+        &taskHandle,
+        CONTROL_TASK_CORE
+    );
+    if (taskHandle == NULL) {
+        LOG_ERROR("CONTROL", "Échec création tâche de régulation");
+        return false;
+    }
+
+    // Le callback ne fait que réveiller la tâche : la tâche esp_timer
+    // n'exécute jamais de lecture I2C ni de calcul.
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = onTimer;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "control";
+    if (esp_timer_create(&timerArgs, &timer) != ESP_OK ||
+        esp_timer_start_periodic(timer, (uint64_t)periodMs * 1000) != ESP_OK) {
+        LOG_ERROR("CONTROL", "Échec démarrage timer de régulation");
+        vTaskDelete(taskHandle);
+        taskHandle = NULL;
+        return false;
+    }
+
+    // Premier cycle immédiat, sans attendre une période complète
+    xTaskNotifyGive(taskHandle);
+    LOG_INFO("CONTROL", "Boucle de régulation démarrée (%lu ms, priorité %d)", (unsigned long)periodMs, CONTROL_TASK_PRIORITY);
+    return true;
+}
+
+void ControlTask::onTimer(void* arg) {
+    xTaskNotifyGive(taskHandle);
+}
+
+void ControlTask::taskLoop(void* arg) {
+    esp_task_wdt_add(NULL);
+    for (;;) {
+        // Le compteur de notifications > 1 signifie que des périodes ont été sautées
+        uint32_t pendingTicks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        int64_t wakeUs = esp_timer_get_time();
+        esp_task_wdt_reset();
+
+        if (stepFunction) {
+            stepFunction();
+        }
+        recordCycle(wakeUs, esp_timer_get_time(), pendingTicks);
+    }
+}
+
+void ControlTask::recordCycle(int64_t wakeUs, int64_t endUs, uint32_t pendingTicks) {
+    portENTER_CRITICAL(&statsMux);
+    if (stats.cycles > 0) {
+        int32_t jitter = (int32_t)(wakeUs - lastWakeUs - (int64_t)stats.periodUs * pendingTicks);
+        uint32_t absJitter = jitter < 0 ? (uint32_t)-jitter : (uint32_t)jitter;
+        stats.lastJitterUs = jitter;
+        if (absJitter > stats.maxJitterUs) stats.maxJitterUs = absJitter;
+        // Moyenne glissante (poids 1/16) de la gigue absolue
+        stats.meanJitterUs = stats.meanJitterUs - stats.meanJitterUs / 16 + absJitter / 16;
+        if (pendingTicks > 1) stats.missedTicks += pendingTicks - 1;
+    }
+    lastWakeUs = wakeUs;
+    stats.cycles++;
+    stats.lastExecUs = (uint32_t)(endUs - wakeUs);
+    if (stats.lastExecUs > stats.maxExecUs) stats.maxExecUs = stats.lastExecUs;
+    portEXIT_CRITICAL(&statsMux);
+}
+
+ControlTimingStats ControlTask::getStats() {
+    portENTER_CRITICAL(&statsMux);
+    ControlTimingStats copy = stats;
+    portEXIT_CRITICAL(&statsMux);
+    return copy;
+}
@@ -0,0 +1,57 @@
+#ifndef CONTROL_TASK_H
+#define CONTROL_TASK_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Statistiques de cadencement de la boucle de régulation (microsecondes).
+// La gigue est l'écart entre deux réveils successifs et la période nominale.
+struct ControlTimingStats {
+    uint32_t periodUs;        // Période nominale
+    uint32_t cycles;          // Cycles exécutés depuis le démarrage
+    uint32_t missedTicks;     // Réveils du timer perdus (cycle précédent trop long)
+    int32_t lastJitterUs;     // Écart signé du dernier cycle
+    uint32_t meanJitterUs;    // Moyenne glissante de |écart|
+    uint32_t maxJitterUs;     // |écart| maximal
+    uint32_t lastExecUs;      // Durée d'exécution du dernier cycle
+    uint32_t maxExecUs;       // Durée d'exécution maximale
+};
+
+// La classe ControlTask exécute la boucle capteur -> chauffage -> sécurité
+// dans une tâche FreeRTOS de haute priorité, réveillée par un esp_timer
+// périodique. La période ne dépend donc plus de l'affichage, des écritures
+// en flash ou du serveur web. C'est une classe statique pour un accès global.
+class ControlTask {
+public:
+    typedef void (*StepFunction)();
+
+    /**
+     * @brief Crée la tâche de régulation et démarre le timer périodique.
+     * @param step La fonction exécutée à chaque période.
+     * @param periodMs La période de régulation en millisecondes.
+     * @return true si le démarrage a réussi, false sinon.
+     */
+    static bool start(StepFunction step, uint32_t periodMs);
+
+    /**
+     * @brief Obtient une copie cohérente des statistiques de cadencement.
+     * @return Les statistiques courantes.
+     */
+    static ControlTimingStats getStats();
+
+private:
+    static StepFunction stepFunction;
+    static esp_timer_handle_t timer;
+    static TaskHandle_t taskHandle;
+    static portMUX_TYPE statsMux;
+    static ControlTimingStats stats;
+    static int64_t lastWakeUs;
+
+    static void onTimer(void* arg);
+    static void taskLoop(void* arg);
+    static void recordCycle(int64_t wakeUs, int64_t endUs, uint32_t pendingTicks);
+};
+
+#endif // CONTROL_TASK_H
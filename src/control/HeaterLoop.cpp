@@ -0,0 +1,88 @@
+#include "HeaterLoop.h"
+#include "../sensors/SafetySystem.h"
+#include <PID_v1.h>
+#include <time.h>
+
+using namespace HardwareConstants;
+using namespace ControlConstants;
+
+// Forward declaration for function in main.cpp
+SystemConfig& getGlobalConfig();
+
+// Contrôle chauffage
+static double input = 0, output = 0;
+static double pidSetpoint = 0; // Consigne en °C (double) pour le PID
+static unsigned long lastToggleTime = 0;
+static bool manualCycleOn = false;
+
+static PID myPID(&input, &output, &pidSetpoint, 2.0, 5.0, 1.0, DIRECT);
+
+void initHeaterLoop() {
+    SystemConfig& config = getGlobalConfig();
+    myPID.SetMode(AUTOMATIC);
+    myPID.SetOutputLimits(0, 255);
+    // Ki/Kd sont mis à l'échelle par la période d'échantillonnage : elle doit
+    // correspondre à la cadence réelle de ControlTask (CONTROL_PERIOD_MS, 2 s),
+    // et non aux 100 ms par défaut de la bibliothèque PID.
+    myPID.SetSampleTime(CONTROL_PERIOD_MS - PID_SAMPLE_MARGIN_MS);
+    myPID.SetTunings(config.Kp, config.Ki, config.Kd);
+}
+
+int16_t getCurrentTargetTemperature() {
+    SystemConfig& config = getGlobalConfig();
+    struct tm timeinfo;
+    if (!getLocalTime(&timeinfo)) {
+        return config.setpoint;
+    }
+    return config.getTempCurve(timeinfo.tm_hour);
+}
+
+void controlHeater(int16_t currentTemperature) {
+    SystemConfig& config = getGlobalConfig();
+    if (SafetySystem::isEmergencyShutdown() || SafetySystem::getCurrentLevel() >= SAFETY_CRITICAL) {
+        output = 0;
+        analogWrite(HEATER_PIN, 0);
+        //LOG_WARN("HEATER", "Chauffage bloqué par le système de sécurité (Niveau: %d)", SafetySystem::getCurrentLevel());
+        return;
+    }
+    
+    int16_t targetTemp = getCurrentTargetTemperature();
+    int16_t maxTemp = targetTemp;
+    int16_t minTemp = targetTemp - (int16_t)(config.hysteresis * 10);
+    unsigned long now = millis();
+    
+    if (currentTemperature >= maxTemp) {
+        output = 0;
+        manualCycleOn = false;
+    } else if (currentTemperature < minTemp) {
+        output = 255;
+        manualCycleOn = false;
+    } else {
+        if (config.usePWM) {
+            input = (double)currentTemperature / 10.0;
+            pidSetpoint = (double)targetTemp / 10.0;
+            myPID.SetTunings(config.Kp, config.Ki, config.Kd);
+            myPID.Compute();
+            output = constrain(output, 0, 255);
+        } else {
+            if (manualCycleOn && now - lastToggleTime >= 990) {
+                manualCycleOn = false;
+                lastToggleTime = now;
+            } else if (!manualCycleOn && now - lastToggleTime >= 2990) {
+                manualCycleOn = true;
+                lastToggleTime = now;
+            }
+            output = manualCycleOn ? 255 : 0;
+        }
+    }
+    
+    if (SafetySystem::getCurrentLevel() == SAFETY_WARNING) {
+        output = min(output, 128.0);
+    }
+    
+    analogWrite(HEATER_PIN, output);
+}
+
+double getHeaterOutput() {
+    return output;
+}
@@ -0,0 +1,33 @@
+#ifndef HEATER_LOOP_H
+#define HEATER_LOOP_H
+
+#include "../config/SystemConfig.h"
+
+// Boucle de régulation du tapis chauffant pilotée par la tâche principale.
+// Elle lit la configuration globale (getGlobalConfig) et commande HEATER_PIN
+// en ON/OFF à hystérésis ou en PID/PWM selon config.usePWM.
+
+/**
+ * @brief Configure le PID (mode, bornes de sortie, gains) depuis la configuration.
+ */
+void initHeaterLoop();
+
+/**
+ * @brief Calcule la consigne de l'heure courante (courbe 24h ou consigne fixe sans NTP).
+ * @return La consigne en int16_t (ex: 230 pour 23.0°C).
+ */
+int16_t getCurrentTargetTemperature();
+
+/**
+ * @brief Exécute un pas de régulation et applique la sortie au chauffage.
+ * @param currentTemperature Température mesurée en int16_t.
+ */
+void controlHeater(int16_t currentTemperature);
+
+/**
+ * @brief Obtient la dernière sortie appliquée au chauffage (0-255).
+ * @return La puissance de sortie.
+ */
+double getHeaterOutput();
+
+#endif // HEATER_LOOP_H
@@ -0,0 +1,13 @@
+#include "SystemSnapshot.h"
+#include "../utils/SeqLock.h"
+
+static SeqLock<SystemSnapshot> snapshotStore;
+
+void publishSystemSnapshot(SystemSnapshot& snapshot) {
+    snapshot.version = snapshotStore.version() + 1;
+    snapshotStore.write(snapshot);
+}
+
+SystemSnapshot getSystemSnapshot() {
+    return snapshotStore.read();
+}
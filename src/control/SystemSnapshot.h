@@ -0,0 +1,51 @@
+#ifndef SYSTEM_SNAPSHOT_H
+#define SYSTEM_SNAPSHOT_H
+
+#include "../config/SystemConfig.h"
+
+// État du système vu par un cycle de régulation, publié en bloc par
+// controlCycle() à chaque période. Les lecteurs des autres tâches (serveur
+// web sur AsyncTCP, affichage OLED) copient le dernier instantané sans verrou
+// et voient donc des valeurs cohérentes entre elles.
+//
+// Structure de valeurs uniquement (copiée par SeqLock) : pas de String.
+struct SystemSnapshot {
+    uint32_t version = 0;            // Numéro de publication (0 = aucune)
+    uint32_t timestampMs = 0;        // millis() de la publication
+
+    // Mesure utilisée par le cycle
+    int16_t temperature = 0;         // En int16_t (ex: 255 pour 25.5°C)
+    float humidity = NAN;
+    bool sensorValid = false;
+    uint32_t sensorSequence = 0;
+    uint32_t sensorTimestampMs = 0;
+    int16_t maxTemperature = -32768;   // Extrêmes du jour local (agrégat journalier)
+    int16_t minTemperature = 32767;
+
+    // Régulation
+    int16_t targetTemperature = 0;
+    float heaterOutput = 0.0f;       // 0-255
+    bool usePWM = false;
+    float Kp = 0.0f, Ki = 0.0f, Kd = 0.0f;
+    float hysteresis = 0.0f;
+
+    // Sécurité
+    SafetyLevel safetyLevel = SAFETY_NORMAL;
+    bool emergencyShutdown = false;
+    char safetyMessage[64] = "";
+};
+
+/**
+ * @brief Publie l'instantané du cycle courant (écrivain unique : la tâche de régulation).
+ * Le champ version est renseigné par la fonction.
+ * @param snapshot L'instantané à publier.
+ */
+void publishSystemSnapshot(SystemSnapshot& snapshot);
+
+/**
+ * @brief Copie le dernier instantané publié, sans verrou, en temps constant.
+ * @return Le dernier instantané (version 0 avant le premier cycle).
+ */
+SystemSnapshot getSystemSnapshot();
+
+#endif // SYSTEM_SNAPSHOT_H
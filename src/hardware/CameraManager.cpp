@@ -1,4 +1,5 @@
 #include "CameraManager.h"
+#include "FrameResponse.h"
 #include "../utils/Logger.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
@@ -26,6 +27,48 @@ bool CameraManager::initialized = false;
 String CameraManager::currentResolution = "qvga";
 int CameraManager::currentQuality = 12;
 camera_config_t CameraManager::cameraConfig = {};
+CameraFrame CameraManager::frames[CameraConstants::FRAME_SLOTS] = {};
+CameraFrame* CameraManager::latestFrame = nullptr;
+portMUX_TYPE CameraManager::frameMux = portMUX_INITIALIZER_UNLOCKED;
+TaskHandle_t CameraManager::captureTask = NULL;
+std::atomic<int> CameraManager::streamClients{0};
+std::atomic<int> CameraManager::captureClients{0};
+std::atomic<uint32_t> CameraManager::frameSequence{0};
+uint32_t CameraManager::droppedFrames = 0;
+CameraManager::LingeringFrame CameraManager::lingering[CameraConstants::MAX_STREAM_CLIENTS + CameraConstants::MAX_CAPTURE_CLIENTS] = {};
+SemaphoreHandle_t CameraManager::streamMutex = NULL;
+FrameResponse* CameraManager::streams[CameraConstants::MAX_STREAM_CLIENTS] = {};
+portMUX_TYPE CameraManager::adaptMux = portMUX_INITIALIZER_UNLOCKED;
+int CameraManager::adaptTop = -1;
+volatile int CameraManager::adaptLevel = -1;
+volatile uint8_t CameraManager::targetFps = CameraConstants::DEFAULT_TARGET_FPS;
+unsigned long CameraManager::windowStart = 0;
+uint16_t CameraManager::windowCaptured = 0;
+uint16_t CameraManager::windowDelivered = 0;
+uint16_t CameraManager::worstIntervalMs = 0;
+uint16_t CameraManager::worstSendMs = 0;
+uint16_t CameraManager::worstBacklog = 0;
+StreamAdaptation CameraManager::lastWindow = {};
+uint8_t CameraManager::recoverWindows = 0;
+uint8_t CameraManager::recoverNeeded = CameraConstants::RECOVER_WINDOWS;
+uint8_t CameraManager::windowsSinceMove = 0;
+bool CameraManager::lastMoveUp = false;
+
+// Échelle du flux adaptatif, du meilleur cran au plus léger : la qualité
+// JPEG baisse d'abord (moins d'octets pour la même image), puis la
+// résolution. Le premier cran de chaque résolution reprend la qualité de
+// configureSettings(). On ne monte jamais au-dessus de la résolution
+// configurée : les tampons du pilote sont alloués pour elle.
+struct AdaptStep {
+    const char* resolution;
+    uint8_t quality;
+};
+static const AdaptStep ADAPT_STEPS[] = {
+    { "svga", 15 }, { "svga", 20 }, { "svga", 25 },
+    { "vga", 12 },  { "vga", 18 },  { "vga", 25 },
+    { "qvga", 12 }, { "qvga", 20 }, { "qvga", 30 },
+};
+static const int ADAPT_STEP_COUNT = sizeof(ADAPT_STEPS) / sizeof(ADAPT_STEPS[0]);
 
 bool CameraManager::initialize(SystemConfig& config) {
     if (initialized) {
@@ -58,6 +101,10 @@ bool CameraManager::initialize(SystemConfig& config) {
     
     initialized = true;
     currentResolution = config.cameraResolution;
+    currentQuality = cameraConfig.jpeg_quality;
+    adaptTop = findStep(config.cameraResolution);
+    adaptLevel = adaptTop;
+    startCapture();
     
     LOG_INFO("CAMERA", "Caméra initialisée en résolution %s", config.cameraResolution.c_str());
     printCameraInfo();
@@ -166,34 +213,20 @@ void CameraManager::handleCapture(AsyncWebServerRequest *request) {
         return;
     }
     
-    camera_fb_t *fb = captureFrame();
-    if (!fb) {
+    // Chaque réponse tient une image jusqu'à son acquittement : le nombre
+    // de clients est borné pour que FRAME_SLOTS suffise toujours
+    if (!admitClient(false)) {
+        request->send(503, "text/plain", "Trop de captures en cours");
+        return;
+    }
+    CameraFrame* frame = snapshot();
+    if (!frame) {
         request->send(500, "text/plain", "Erreur capture image");
         return;
     }
     
-    AsyncWebServerResponse *response = request->beginResponse(
-        "image/jpeg", 
-        fb->len,
-        [fb](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
-            if (index >= fb->len) {
-                releaseFrame(fb);
-                return 0;
-            }
-            
-            size_t bytesToCopy = min(maxLen, fb->len - index);
-            memcpy(buffer, fb->buf + index, bytesToCopy);
-            
-            if (index + bytesToCopy >= fb->len) {
-                releaseFrame(fb);
-            }
-            
-            return bytesToCopy;
-        }
-    );
-    
-    response->addHeader("Cache-Control", "no-cache");
-    request->send(response);
+    // Le JPEG part par référence ; la réponse rend l'image une fois acquittée
+    request->send(new FrameResponse(frame));
 }
 
 void CameraManager::handleStream(AsyncWebServerRequest *request) { // Renommée pour correspondre au .h
@@ -201,83 +234,334 @@ void CameraManager::handleStream(AsyncWebServerRequest *request) { // Renommée
         request->send(503, "text/plain", "Caméra non initialisée");
         return;
     }
-    
-    AsyncWebServerResponse *response = request->beginChunkedResponse(
-        "multipart/x-mixed-replace; boundary=--frame",
-        [](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
-            static camera_fb_t *fb = nullptr;
-            static size_t sent = 0;
-            static bool headerSent = false;
-            
-            // Nouvelle frame
-            if (index == 0 || (!fb && sent == 0)) {
-                if (fb) releaseFrame(fb);
-                
-                fb = captureFrame();
-                if (!fb) return 0;
-                
-                sent = 0;
-                headerSent = false;
+    if (!admitClient(true)) {
+        request->send(503, "text/plain", "Trop de flux ouverts");
+        return;
+    }
+
+    // Chaque connexion a sa réponse ; toutes lisent les mêmes images. Un
+    // client lent prend la dernière image une fois la précédente acquittée
+    // et saute donc celles capturées entre-temps, sans retenir la capture.
+    request->send(new FrameResponse());
+}
+
+// === Tâche de capture partagée ===
+
+void CameraManager::startCapture() {
+    if (captureTask) return;
+    for (int i = 0; i < CameraConstants::FRAME_SLOTS; i++) {
+        frames[i] = CameraFrame{ nullptr, 0, 0, 0, 0, 0, 0 };
+    }
+    if (!streamMutex) streamMutex = xSemaphoreCreateMutex();
+    xTaskCreatePinnedToCore(captureLoop, "CameraCapture", CameraConstants::CAPTURE_TASK_STACK, NULL,
+                            CameraConstants::CAPTURE_TASK_PRIORITY, &captureTask, CameraConstants::CAPTURE_TASK_CORE);
+    if (captureTask == NULL) {
+        LOG_ERROR("CAMERA", "Impossible de créer la tâche de capture");
+    }
+}
+
+void CameraManager::captureLoop(void* arg) {
+    for (;;) {
+        expireLingering();
+        if (!initialized || streamClients.load() <= 0) {
+            // Plus de spectateur : le prochain flux, /capture et le time-lapse
+            // repartent du meilleur cran, pas de celui du dernier client lent
+            if (initialized && adaptTop >= 0 && adaptLevel != adaptTop && applyStep(adaptTop)) {
+                recoverWindows = 0;
+                recoverNeeded = CameraConstants::RECOVER_WINDOWS;
+                windowsSinceMove = 0;
+                lastMoveUp = false;
+                LOG_INFO("CAMERA", "Flux adaptatif : retour à %s q%u", ADAPT_STEPS[adaptTop].resolution,
+                         ADAPT_STEPS[adaptTop].quality);
             }
-            
-            if (!fb) return 0;
-            
-            // Envoyer l'en-tête MJPEG
-            if (!headerSent) {
-                String header = "\r\n--frame\r\n";
-                header += "Content-Type: image/jpeg\r\n";
-                header += "Content-Length: " + String(fb->len) + "\r\n\r\n";
-                
-                size_t headerLen = min((size_t)header.length(), maxLen);
-                memcpy(buffer, header.c_str(), headerLen);
-                
-                if (headerLen < header.length()) {
-                    // Pas assez de place, on abandonne
-                    releaseFrame(fb);
-                    fb = nullptr;
-                    return 0;
+            // Réveillée par handleStream() à l'ouverture d'un flux
+            resetWindow();
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+            continue;
+        }
+        camera_fb_t* fb = esp_camera_fb_get();
+        if (!fb) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+        // Le tampon du pilote est rendu aussitôt copié
+        bool published = publishFrame(fb);
+        esp_camera_fb_return(fb);
+        if (published) {
+            windowCaptured++;
+            wakeStreams();
+        } else {
+            droppedFrames++;
+        }
+
+        if (millis() - windowStart >= CameraConstants::ADAPT_WINDOW_MS) adapt();
+    }
+}
+
+bool CameraManager::publishFrame(const camera_fb_t* fb) {
+    // Emplacement libre : ni la dernière image, ni une image en cours d'envoi
+    CameraFrame* slot = nullptr;
+    portENTER_CRITICAL(&frameMux);
+    for (int i = 0; i < CameraConstants::FRAME_SLOTS && !slot; i++) {
+        if (frames[i].refs == 0) slot = &frames[i];
+    }
+    if (slot) slot->refs = 1;   // Réservé pendant la copie
+    portEXIT_CRITICAL(&frameMux);
+    if (!slot) return false;    // Tous les emplacements sont tenus par des clients lents
+
+    if (slot->capacity < fb->len) {
+        free(slot->data);
+        slot->capacity = fb->len + fb->len / 4;
+        slot->data = (uint8_t*)ps_malloc(slot->capacity);
+        if (!slot->data) slot->data = (uint8_t*)malloc(slot->capacity);
+        if (!slot->data) {
+            slot->capacity = 0;
+            portENTER_CRITICAL(&frameMux);
+            slot->refs = 0;
+            portEXIT_CRITICAL(&frameMux);
+            return false;
+        }
+    }
+    memcpy(slot->data, fb->buf, fb->len);
+    slot->length = fb->len;
+    slot->width = fb->width;
+    slot->height = fb->height;
+    slot->sequence = ++frameSequence;
+
+    // La référence de réservation devient celle de "dernière image"
+    portENTER_CRITICAL(&frameMux);
+    CameraFrame* previous = latestFrame;
+    latestFrame = slot;
+    if (previous) previous->refs--;
+    portEXIT_CRITICAL(&frameMux);
+    return true;
+}
+
+CameraFrame* CameraManager::acquireFrame(uint32_t afterSequence, uint32_t waitMs) {
+    unsigned long start = millis();
+    for (;;) {
+        CameraFrame* frame = nullptr;
+        portENTER_CRITICAL(&frameMux);
+        if (latestFrame && latestFrame->sequence != afterSequence) {
+            frame = latestFrame;
+            frame->refs++;
+        }
+        portEXIT_CRITICAL(&frameMux);
+        if (frame || millis() - start >= waitMs) return frame;
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+}
+
+void CameraManager::releaseFrame(CameraFrame* frame) {
+    if (!frame) return;
+    portENTER_CRITICAL(&frameMux);
+    frame->refs--;
+    portEXIT_CRITICAL(&frameMux);
+}
+
+bool CameraManager::admitClient(bool stream) {
+    // Les connexions fermées avant l'acquittement tiennent encore leur image
+    int held = streamClients.load() + captureClients.load() + expireLingering();
+    if (held >= CameraConstants::MAX_STREAM_CLIENTS + CameraConstants::MAX_CAPTURE_CLIENTS) return false;
+    return stream ? streamClients.load() < CameraConstants::MAX_STREAM_CLIENTS
+                  : captureClients.load() < CameraConstants::MAX_CAPTURE_CLIENTS;
+}
+
+bool CameraManager::registerStream(FrameResponse* response) {
+    for (int i = 0; i < CameraConstants::MAX_STREAM_CLIENTS; i++) {
+        if (!streams[i]) {
+            streams[i] = response;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CameraManager::unregisterStream(FrameResponse* response) {
+    for (int i = 0; i < CameraConstants::MAX_STREAM_CLIENTS; i++) {
+        if (streams[i] == response) streams[i] = nullptr;
+    }
+}
+
+void CameraManager::wakeStreams() {
+    // Les flux à jour attendent cette image : ils l'envoient sans attendre
+    // le prochain rappel AsyncTCP (poll toutes les 500 ms)
+    xSemaphoreTake(streamMutex, portMAX_DELAY);
+    for (int i = 0; i < CameraConstants::MAX_STREAM_CLIENTS; i++) {
+        if (streams[i]) streams[i]->wake();
+    }
+    xSemaphoreGive(streamMutex);
+}
+
+void CameraManager::lingerFrame(CameraFrame* frame) {
+    // lwIP garde les segments non acquittés après tcp_close et peut les
+    // retransmettre : ils pointent dans l'image, qui reste donc tenue.
+    // admitClient() garantit une entrée libre.
+    bool kept = false;
+    portENTER_CRITICAL(&frameMux);
+    for (auto& entry : lingering) {
+        if (!entry.frame) {
+            entry.frame = frame;
+            entry.since = millis();
+            kept = true;
+            break;
+        }
+    }
+    if (!kept) frame->refs--;
+    portEXIT_CRITICAL(&frameMux);
+}
+
+int CameraManager::expireLingering() {
+    int count = 0;
+    unsigned long now = millis();
+    portENTER_CRITICAL(&frameMux);
+    for (auto& entry : lingering) {
+        if (!entry.frame) continue;
+        if (now - entry.since >= CameraConstants::FRAME_LINGER_MS) {
+            entry.frame->refs--;
+            entry.frame = nullptr;
+        } else {
+            count++;
+        }
+    }
+    portEXIT_CRITICAL(&frameMux);
+    return count;
+}
+
+CameraFrame* CameraManager::snapshot() {
+    if (!initialized) return nullptr;
+    if (streamClients.load() > 0) {
+        CameraFrame* frame = acquireFrame(0, CameraConstants::FRAME_WAIT_MS);
+        if (frame) return frame;
+    }
+
+    // Pas de flux : capture directe, détachée du pilote comme dans captureLoop
+    camera_fb_t* fb = esp_camera_fb_get();
+    if (!fb) return nullptr;
+    bool published = publishFrame(fb);
+    esp_camera_fb_return(fb);
+    return published ? acquireFrame(0, 0) : nullptr;
+}
+
+// === Flux adaptatif ===
+
+void CameraManager::reportDelivery(uint16_t intervalMs, uint16_t sendMs, uint16_t backlogFrames) {
+    portENTER_CRITICAL(&adaptMux);
+    if (windowDelivered < UINT16_MAX) windowDelivered++;
+    worstIntervalMs = max(worstIntervalMs, intervalMs);
+    worstSendMs = max(worstSendMs, sendMs);
+    worstBacklog = max(worstBacklog, backlogFrames);
+    portEXIT_CRITICAL(&adaptMux);
+}
+
+void CameraManager::resetWindow() {
+    portENTER_CRITICAL(&adaptMux);
+    windowDelivered = 0;
+    worstIntervalMs = 0;
+    worstSendMs = 0;
+    worstBacklog = 0;
+    portEXIT_CRITICAL(&adaptMux);
+    windowCaptured = 0;
+    windowStart = millis();
+}
+
+void CameraManager::adapt() {
+    uint32_t elapsed = millis() - windowStart;
+    StreamAdaptation window = {};
+    portENTER_CRITICAL(&adaptMux);
+    uint16_t delivered = windowDelivered;
+    uint16_t intervalMs = worstIntervalMs;
+    window.sendMs = worstSendMs;
+    window.backlogFrames = worstBacklog;
+    portEXIT_CRITICAL(&adaptMux);
+    window.captureFps10 = (uint16_t)(windowCaptured * 10000UL / (elapsed ? elapsed : 1));
+    // Intervalle lissé du client le plus lent ; aucune image livrée de
+    // toute la fenêtre : le réseau ne suit plus du tout
+    window.achievedFps10 = (delivered > 0 && intervalMs > 0)
+        ? (uint16_t)min(10000UL / intervalMs, (unsigned long)window.captureFps10) : 0;
+    resetWindow();
+
+    int level = adaptLevel;
+    uint8_t target = targetFps;
+    if (adaptTop >= 0 && level >= 0) {
+        if (windowsSinceMove < UINT8_MAX) windowsSinceMove++;
+        uint32_t budgetMs = 1000 / target;
+        if (window.achievedFps10 * 1000UL < target * 10UL * CameraConstants::DEGRADE_PERMILLE) {
+            recoverWindows = 0;
+            if (level + 1 < ADAPT_STEP_COUNT && applyStep(level + 1)) {
+                // Retombée juste après une remontée : la prochaine attendra deux fois plus
+                if (lastMoveUp && windowsSinceMove <= recoverNeeded) {
+                    recoverNeeded = min((uint8_t)(recoverNeeded * 2), CameraConstants::RECOVER_WINDOWS_MAX);
                 }
-                
-                headerSent = true;
-                return headerLen;
+                lastMoveUp = false;
+                windowsSinceMove = 0;
             }
-            
-            // Envoyer les données JPEG
-            size_t toSend = min(maxLen, fb->len - sent);
-            memcpy(buffer, fb->buf + sent, toSend);
-            sent += toSend;
-            
-            // Frame terminée ?
-            if (sent >= fb->len) {
-                releaseFrame(fb);
-                fb = nullptr;
-                sent = 0;
+        } else if (level > adaptTop && window.sendMs * 1000UL < budgetMs * CameraConstants::RECOVER_SEND_PERMILLE) {
+            if (++recoverWindows >= recoverNeeded && applyStep(level - 1)) {
+                // Deux remontées de suite : la précédente a tenu
+                if (lastMoveUp) recoverNeeded = CameraConstants::RECOVER_WINDOWS;
+                lastMoveUp = true;
+                windowsSinceMove = 0;
+                recoverWindows = 0;
             }
-            
-            return toSend;
+        } else {
+            recoverWindows = 0;
         }
-    );
-    
-    // En-têtes spécifiques MJPEG
-    response->addHeader("Access-Control-Allow-Origin", "*");
-    response->addHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-    response->addHeader("Pragma", "no-cache");
-    response->addHeader("Expires", "0");
-    response->addHeader("Connection", "close");
-    
-    request->send(response);
+        if (adaptLevel != level) {
+            LOG_INFO("CAMERA", "Flux adaptatif : %s q%u (%u.%u FPS livrés pour %u visés, envoi %u ms)",
+                     ADAPT_STEPS[adaptLevel].resolution, ADAPT_STEPS[adaptLevel].quality,
+                     window.achievedFps10 / 10, window.achievedFps10 % 10, target, window.sendMs);
+        }
+    }
+
+    portENTER_CRITICAL(&adaptMux);
+    lastWindow = window;
+    portEXIT_CRITICAL(&adaptMux);
 }
 
-// === Capture et libération des frames ===
+bool CameraManager::applyStep(int level) {
+    sensor_t* s = esp_camera_sensor_get();
+    if (!s) return false;
+    const AdaptStep& step = ADAPT_STEPS[level];
+    const AdaptStep& current = ADAPT_STEPS[adaptLevel];
+    if (strcmp(step.resolution, current.resolution) != 0 &&
+        s->set_framesize(s, stringToFramesize(step.resolution)) != 0) {
+        return false;
+    }
+    if (s->set_quality(s, step.quality) != 0) return false;
+    currentQuality = step.quality;
+    adaptLevel = level;
+    return true;
+}
 
-camera_fb_t* CameraManager::captureFrame() {
-    if (!initialized) return nullptr;
-    return esp_camera_fb_get();
+int CameraManager::findStep(const String& resolution) {
+    for (int i = 0; i < ADAPT_STEP_COUNT; i++) {
+        if (resolution == ADAPT_STEPS[i].resolution) return i;
+    }
+    return -1;
 }
 
-void CameraManager::releaseFrame(camera_fb_t* frame) {
-    if (!initialized || !frame) return;
-    esp_camera_fb_return(frame);
+StreamAdaptation CameraManager::getStreamAdaptation() {
+    portENTER_CRITICAL(&adaptMux);
+    StreamAdaptation state = lastWindow;
+    portEXIT_CRITICAL(&adaptMux);
+
+    int level = adaptLevel;
+    state.adaptive = adaptTop >= 0 && level >= 0;
+    state.resolution = state.adaptive ? ADAPT_STEPS[level].resolution : currentResolution.c_str();
+    state.quality = state.adaptive ? ADAPT_STEPS[level].quality : currentQuality;
+    state.level = state.adaptive ? level : 0;
+    state.levels = ADAPT_STEP_COUNT;
+    state.targetFps = targetFps;
+    state.clients = streamClients.load();
+
+    portENTER_CRITICAL(&frameMux);
+    if (latestFrame) {
+        state.width = latestFrame->width;
+        state.height = latestFrame->height;
+    }
+    portEXIT_CRITICAL(&frameMux);
+    return state;
 }
 
 // === Configuration dynamique ===
@@ -294,6 +578,13 @@ bool CameraManager::setResolution(const String& resolution, SystemConfig& config
     if (s->set_framesize(s, frameSize) == 0) {
         currentResolution = resolution;
         config.cameraResolution = resolution; // Mettre à jour la config
+        // Nouveau plafond du flux adaptatif, repris à son meilleur cran
+        int top = findStep(resolution);
+        if (top >= 0 && s->set_quality(s, ADAPT_STEPS[top].quality) == 0) {
+            currentQuality = ADAPT_STEPS[top].quality;
+        }
+        adaptTop = top;
+        adaptLevel = top;
         LOG_INFO("CAMERA", "Résolution changée en %s", resolution.c_str());
         return true;
     }
@@ -301,12 +592,11 @@ bool CameraManager::setResolution(const String& resolution, SystemConfig& config
     return false;
 }
 
-void CameraManager::setFramerate(int targetFps, SystemConfig& config) { // Signature corrigée
-    // Cette fonction est une simplification, le framerate dépend de plusieurs facteurs
-    // Pour l'instant, elle ne fait que changer la résolution
-    if (targetFps > 20) setResolution("qvga", config);
-    else if (targetFps > 10) setResolution("vga", config);
-    else setResolution("svga", config);
+void CameraManager::setFramerate(int fps) {
+    // Le débit dépend surtout de la taille des JPEG : c'est le flux adaptatif
+    // qui choisit qualité et résolution pour tenir cette cible
+    targetFps = (uint8_t)constrain(fps, 1, (int)CameraConstants::MAX_TARGET_FPS);
+    LOG_INFO("CAMERA", "Débit visé du flux : %u FPS", targetFps);
 }
 
 // === Utilitaires ===
@@ -4,6 +4,44 @@
 #include "../config/SystemConfig.h" // Pour l'accès à la structure de configuration
 #include "esp_camera.h"             // Pour les types et fonctions de la caméra
 #include <ESPAsyncWebServer.h>      // Pour les types du serveur web
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <atomic>
+
+class FrameResponse;
+
+// Image JPEG détachée du pilote, en PSRAM, partagée entre les clients du
+// flux. refs compte la référence "dernière image", celle de chaque client
+// en cours d'envoi et celle des connexions fermées avant l'acquittement
+// (lingerFrame) ; un emplacement n'est réutilisé qu'à refs == 0.
+struct CameraFrame {
+    uint8_t* data;
+    size_t length;
+    size_t capacity;
+    uint16_t width;
+    uint16_t height;
+    uint32_t sequence;        // Numéro de capture, croissant (0 : jamais rempli)
+    uint16_t refs;            // Protégé par frameMux
+};
+
+// État du flux adaptatif, pour /mjpeg/info. Les débits sont en dixièmes
+// d'image par seconde, mesurés sur la dernière fenêtre.
+struct StreamAdaptation {
+    bool adaptive;            // false si la résolution configurée est hors de l'échelle
+    const char* resolution;
+    uint8_t quality;          // jpeg_quality du capteur (plus petit : meilleure qualité)
+    uint8_t level;            // Cran de l'échelle (0 : le meilleur)
+    uint8_t levels;
+    uint8_t targetFps;
+    uint16_t captureFps10;    // Images capturées
+    uint16_t achievedFps10;   // Images livrées au client le plus lent
+    uint16_t sendMs;          // Pire temps d'envoi d'une image
+    uint16_t backlogFrames;   // Pire retard d'un client sur la capture, en images
+    uint16_t width;           // Dernière image
+    uint16_t height;
+    int clients;
+};
 
 // La classe CameraManager regroupe toutes les fonctionnalités liées à la caméra.
 // Elle est conçue comme une classe statique (pas besoin de créer d'objet)
@@ -35,12 +73,23 @@ public:
     static void testSpeed();
 
     /**
-     * @brief Change la résolution de la caméra à la volée.
+     * @brief Change la résolution de la caméra à la volée. Elle devient le
+     * plafond du flux adaptatif, qui repart de son meilleur cran.
      * @param resolution La nouvelle résolution ("qvga", "vga", "svga").
      * @param config Référence à la configuration pour la mettre à jour.
      */
-    bool setResolution(const String& resolution, SystemConfig& config);
-    void setFramerate(int framerate, SystemConfig& config);
+    static bool setResolution(const String& resolution, SystemConfig& config);
+
+    /**
+     * @brief Fixe le débit que le flux adaptatif cherche à tenir.
+     * @param targetFps Images par seconde visées (1 à MAX_TARGET_FPS).
+     */
+    static void setFramerate(int targetFps);
+
+    /**
+     * @brief Renvoie l'état du flux adaptatif (résolution, qualité, mesures).
+     */
+    static StreamAdaptation getStreamAdaptation();
 
     /**
      * @brief Affiche les informations du capteur de la caméra.
@@ -109,14 +158,96 @@ public:
      */
     static void handleMjpeg(AsyncWebServerRequest *request);
 
+    /**
+     * @brief Convertit un nom de résolution ("qvga", "vga"...) en framesize_t.
+     * @param resolution Le nom de la résolution.
+     * @return La taille d'image, ou FRAMESIZE_INVALID si le nom est inconnu.
+     */
+    static framesize_t stringToFramesize(const String& resolution);
+
+    /**
+     * @brief Prend une référence sur la dernière image capturée, si elle est
+     * plus récente que afterSequence. Attend au plus waitMs une image neuve.
+     * @return L'image (à rendre par releaseFrame), nullptr si aucune.
+     */
+    static CameraFrame* acquireFrame(uint32_t afterSequence, uint32_t waitMs);
+
+    /**
+     * @brief Rend une référence prise par acquireFrame().
+     */
+    static void releaseFrame(CameraFrame* frame);
+
+    /**
+     * @brief Prend une référence sur une image fraîche : la dernière du flux
+     * si la capture tourne, sinon une capture immédiate détachée du pilote.
+     * @return L'image (à rendre par releaseFrame), nullptr en cas d'échec.
+     */
+    static CameraFrame* snapshot();
+
 private:
+    friend class FrameResponse;
+
+    // Image d'une connexion fermée avant l'acquittement de son JPEG
+    struct LingeringFrame {
+        CameraFrame* frame;
+        unsigned long since;
+    };
+
+    // Tâche de capture : une seule lecture du capteur par image, quel que
+    // soit le nombre de clients ; elle dort tant qu'aucun flux n'est ouvert.
+    static CameraFrame frames[CameraConstants::FRAME_SLOTS];
+    static CameraFrame* latestFrame;
+    static portMUX_TYPE frameMux;
+    static TaskHandle_t captureTask;
+    static std::atomic<int> streamClients;
+    static std::atomic<int> captureClients;
+    static std::atomic<uint32_t> frameSequence;
+    static uint32_t droppedFrames;
+    static LingeringFrame lingering[CameraConstants::MAX_STREAM_CLIENTS + CameraConstants::MAX_CAPTURE_CLIENTS];
+
+    // Flux ouverts, que la tâche de capture réveille à chaque image.
+    // streamMutex sérialise ces réveils avec les rappels AsyncTCP du flux.
+    static SemaphoreHandle_t streamMutex;
+    static FrameResponse* streams[CameraConstants::MAX_STREAM_CLIENTS];
+
+    static void startCapture();
+    static void captureLoop(void* arg);
+    static bool publishFrame(const camera_fb_t* fb);
+    static bool admitClient(bool stream);
+    static bool registerStream(FrameResponse* response);
+    static void unregisterStream(FrameResponse* response);
+    static void wakeStreams();
+    static void lingerFrame(CameraFrame* frame);
+    static int expireLingering();
+
+    // Flux adaptatif : la tâche de capture mesure et décide ; les réponses
+    // du flux rapportent chaque image livrée (rappel AsyncTCP).
+    static portMUX_TYPE adaptMux;
+    static int adaptTop;                  // Meilleur cran permis, -1 : adaptation coupée
+    static volatile int adaptLevel;
+    static volatile uint8_t targetFps;
+    static unsigned long windowStart;
+    static uint16_t windowCaptured;
+    static uint16_t windowDelivered;      // Protégés par adaptMux
+    static uint16_t worstIntervalMs;
+    static uint16_t worstSendMs;
+    static uint16_t worstBacklog;
+    static StreamAdaptation lastWindow;   // Protégé par adaptMux
+    static uint8_t recoverWindows;
+    static uint8_t recoverNeeded;
+    static uint8_t windowsSinceMove;
+    static bool lastMoveUp;
+
+    static void reportDelivery(uint16_t intervalMs, uint16_t sendMs, uint16_t backlogFrames);
+    static void resetWindow();
+    static void adapt();
+    static bool applyStep(int level);
+    static int findStep(const String& resolution);
+
     static void configurePins();
     static bool configureSettings(const String& resolution);
     static bool testCapture();
     static void optimizeForSpeed();
-    static camera_fb_t* captureFrame();
-    static void releaseFrame(camera_fb_t* frame);
-    static framesize_t stringToFramesize(const String& resolution);
     static void handleMJPEGStream(AsyncWebServerRequest *request);
 };
 
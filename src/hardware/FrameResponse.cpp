@@ -0,0 +1,147 @@
+#include "FrameResponse.h"
+#include "../utils/Logger.h"
+
+static const char PART_TRAILER[] = "\r\n";   // Stockage statique : envoyé par référence
+
+FrameResponse::FrameResponse(CameraFrame* frame) : stream(false), frame(frame), phase(PHASE_JPEG) {
+    _code = 200;
+    CameraManager::captureClients++;
+    head = "HTTP/1.1 200 OK\r\n"
+           "Content-Type: image/jpeg\r\n"
+           "Content-Length: " + String((unsigned long)frame->length) + "\r\n"
+           "Cache-Control: no-cache\r\n"
+           "Connection: close\r\n\r\n";
+}
+
+FrameResponse::FrameResponse() : stream(true) {
+    _code = 200;
+    head = "HTTP/1.1 200 OK\r\n"
+           "Content-Type: multipart/x-mixed-replace; boundary=frame\r\n"
+           "Access-Control-Allow-Origin: *\r\n"
+           "Cache-Control: no-cache, no-store, must-revalidate\r\n"
+           "Pragma: no-cache\r\n"
+           "Expires: 0\r\n"
+           "Connection: close\r\n\r\n";
+    CameraManager::streamClients++;
+    if (CameraManager::captureTask) xTaskNotifyGive(CameraManager::captureTask);
+}
+
+FrameResponse::~FrameResponse() {
+    if (stream) {
+        xSemaphoreTake(CameraManager::streamMutex, portMAX_DELAY);
+        CameraManager::unregisterStream(this);
+        xSemaphoreGive(CameraManager::streamMutex);
+    }
+    // Octets non acquittés : après tcp_close, lwIP peut encore retransmettre
+    // ceux passés par référence, l'image est gardée un moment
+    if (frame && acked < queued) CameraManager::lingerFrame(frame);
+    else CameraManager::releaseFrame(frame);
+    if (stream) CameraManager::streamClients--;
+    else CameraManager::captureClients--;
+}
+
+void FrameResponse::_respond(AsyncWebServerRequest* request) {
+    this->request = request;
+    _state = RESPONSE_CONTENT;
+    if (!stream) {
+        fill();
+        return;
+    }
+    xSemaphoreTake(CameraManager::streamMutex, portMAX_DELAY);
+    if (!CameraManager::registerStream(this)) {
+        LOG_WARN("CAMERA", "Flux non enregistré : il ne suivra que les acquittements");
+    }
+    nextFrame();
+    fill();
+    xSemaphoreGive(CameraManager::streamMutex);
+}
+
+size_t FrameResponse::_ack(AsyncWebServerRequest* request, size_t len, uint32_t time) {
+    if (stream) xSemaphoreTake(CameraManager::streamMutex, portMAX_DELAY);
+    acked += len;
+    advance();
+    if (stream) xSemaphoreGive(CameraManager::streamMutex);
+    return len;
+}
+
+void FrameResponse::wake() {
+    if (request && _state == RESPONSE_CONTENT && phase == PHASE_NONE && nextFrame()) fill();
+}
+
+void FrameResponse::advance() {
+    // Partie entièrement confiée à TCP et JPEG acquitté : l'image peut être rendue
+    if (phase == PHASE_QUEUED && acked >= frameEnd) {
+        lastSequence = frame->sequence;
+        if (stream) reportDelivery();
+        CameraManager::releaseFrame(frame);
+        frame = nullptr;
+        phase = PHASE_NONE;
+    }
+    if (!stream) {
+        if (phase == PHASE_NONE && acked >= queued) _state = RESPONSE_END;
+    } else if (phase == PHASE_NONE) {
+        // Pas d'image plus récente : wake() reprendra à la prochaine capture
+        nextFrame();
+    }
+    fill();
+}
+
+void FrameResponse::reportDelivery() {
+    unsigned long now = millis();
+    uint16_t sendMs = (uint16_t)min(now - frameStart, 65535UL);
+    uint16_t interval = lastDelivery ? (uint16_t)min(now - lastDelivery, 65535UL) : sendMs;
+    // Moyenne glissante de poids 1/4 : une image isolée ne fait pas basculer
+    intervalMs = intervalMs ? intervalMs + ((int)interval - (int)intervalMs) / 4 : interval;
+    lastDelivery = now;
+    uint32_t behind = CameraManager::frameSequence.load() - frame->sequence;
+    CameraManager::reportDelivery(intervalMs, sendMs, (uint16_t)min(behind, (uint32_t)UINT16_MAX));
+}
+
+bool FrameResponse::nextFrame() {
+    CameraFrame* next = CameraManager::acquireFrame(lastSequence, 0);
+    if (!next) return false;
+    frame = next;
+    frameStart = millis();
+    phase = PHASE_JPEG;
+    partQueued = 0;
+    // Le premier en-tête de partie suit l'en-tête HTTP s'il n'est pas encore parti
+    String part = "--frame\r\nContent-Type: image/jpeg\r\nContent-Length: " + String((unsigned long)frame->length) + "\r\n\r\n";
+    if (headSent < head.length()) {
+        head += part;
+    } else {
+        head = part;
+        headSent = 0;
+    }
+    return true;
+}
+
+void FrameResponse::fill() {
+    AsyncClient* client = request ? request->client() : nullptr;
+    if (!client) return;
+    bool added = false;
+    for (;;) {
+        size_t space = client->space();
+        if (space == 0) break;
+        size_t n = 0;
+        if (headSent < head.length()) {
+            n = client->add(head.c_str() + headSent, min(space, head.length() - headSent));
+            headSent += n;
+        } else if (phase == PHASE_JPEG) {
+            n = client->add((const char*)frame->data + partQueued, min(space, frame->length - partQueued), 0);
+            partQueued += n;
+            if (n > 0 && partQueued == frame->length) {
+                frameEnd = queued + n;
+                partQueued = 0;
+                phase = stream ? PHASE_TRAILER : PHASE_QUEUED;
+            }
+        } else if (phase == PHASE_TRAILER) {
+            n = client->add(PART_TRAILER + partQueued, min(space, sizeof(PART_TRAILER) - 1 - partQueued), 0);
+            partQueued += n;
+            if (partQueued == sizeof(PART_TRAILER) - 1) phase = PHASE_QUEUED;
+        }
+        if (n == 0) break;
+        queued += n;
+        added = true;
+    }
+    if (added) client->send();
+}
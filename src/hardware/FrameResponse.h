@@ -0,0 +1,67 @@
+#ifndef FRAME_RESPONSE_H
+#define FRAME_RESPONSE_H
+
+#include "CameraManager.h"
+#include <ESPAsyncWebServer.h>
+
+// Réponse HTTP qui envoie des CameraFrame sans recopie : le JPEG est confié
+// à TCP par référence (add() sans ASYNC_WRITE_FLAG_COPY, donc tcp_write sans
+// TCP_WRITE_FLAG_COPY) et l'image reste référencée jusqu'à l'acquittement de
+// son dernier octet. Seuls l'en-tête HTTP et les en-têtes de partie, quelques
+// dizaines d'octets, sont copiés.
+//
+// Une image : /capture, puis fin de la réponse. Flux : /mjpeg, multipart
+// sans fin ; chaque image acquittée est remplacée par la plus récente, un
+// client lent saute donc des images sans retenir la capture. Aucune attente
+// dans les rappels AsyncTCP : un flux à jour attend la prochaine capture,
+// que la tâche de capture lui passe par wake(). Chaque image livrée est
+// rapportée au flux adaptatif de CameraManager : intervalle lissé entre
+// deux images, temps d'envoi et retard sur la capture.
+class FrameResponse : public AsyncWebServerResponse {
+public:
+    explicit FrameResponse(CameraFrame* frame);   // Prend la référence de frame
+    FrameResponse();                              // Flux
+    ~FrameResponse();
+
+    bool _sourceValid() const override { return true; }
+    void _respond(AsyncWebServerRequest* request) override;
+    size_t _ack(AsyncWebServerRequest* request, size_t len, uint32_t time) override;
+
+    /**
+     * @brief Flux sans image en cours : prend la nouvelle capture et
+     * l'envoie. Appelée par la tâche de capture, sous streamMutex.
+     */
+    void wake();
+
+private:
+    // Étape de la partie en cours. L'image n'est rendue qu'une fois la
+    // partie entièrement confiée à TCP (PHASE_QUEUED) et son JPEG acquitté.
+    enum Phase {
+        PHASE_NONE,       // Pas d'image : en attente d'une capture (flux) ou terminé
+        PHASE_JPEG,       // En-têtes puis JPEG en cours d'envoi
+        PHASE_TRAILER,    // "\r\n" de fin de partie en cours d'envoi (flux)
+        PHASE_QUEUED      // Partie entièrement confiée à TCP, en attente d'acquittement
+    };
+
+    bool stream;
+    AsyncWebServerRequest* request = nullptr;
+    String head;               // En-tête HTTP, puis en-tête de la partie en cours
+    size_t headSent = 0;
+    CameraFrame* frame = nullptr;
+    Phase phase = PHASE_NONE;
+    size_t partQueued = 0;     // Octets du JPEG ou de la fin de partie confiés à TCP
+    size_t frameEnd = 0;       // Position du dernier octet du JPEG dans la réponse
+    size_t queued = 0;         // Octets confiés à TCP
+    size_t acked = 0;          // Octets acquittés par le client
+    uint32_t lastSequence = 0;
+    unsigned long frameStart = 0;     // Prise de l'image en cours (flux)
+    unsigned long lastDelivery = 0;
+    uint16_t intervalMs = 0;          // Intervalle lissé entre deux images livrées
+
+    bool nextFrame();
+    void advance();
+    void reportDelivery();
+    void fill();
+};
+
+#endif // FRAME_RESPONSE_H
@@ -6,7 +6,7 @@ PID* HeaterControl::pidController = nullptr;
 int HeaterControl::pin = -1;
 double HeaterControl::pidInput = 0;
 double HeaterControl::pidOutput = 0;
-int16_t HeaterControl::pidSetpoint = 230; // Changé en int16_t
+double HeaterControl::pidSetpoint = 23.0; // En °C, comme pidInput
 float HeaterControl::currentOutput = 0;
 int16_t HeaterControl::hysteresisValue = 3; // Changé en int16_t (0.3 * 10)
 bool HeaterControl::pidMode = false;
@@ -27,7 +27,7 @@ bool HeaterControl::initialize(int heaterPin) {
     analogWrite(pin, 0);
     
     // Initialiser le PID
-    pidController = new PID(&pidInput, &pidOutput, (double*)&pidSetpoint, 2.0, 5.0, 1.0, DIRECT); // Cast pidSetpoint
+    pidController = new PID(&pidInput, &pidOutput, &pidSetpoint, 2.0, 5.0, 1.0, DIRECT);
     if (!pidController) {
         LOG_ERROR("HEATER", "Échec création contrôleur PID");
         return false;
@@ -35,6 +35,7 @@ bool HeaterControl::initialize(int heaterPin) {
     
     pidController->SetMode(AUTOMATIC);
     pidController->SetOutputLimits(0, 255);
+    pidController->SetSampleTime(ControlConstants::CONTROL_PERIOD_MS - ControlConstants::PID_SAMPLE_MARGIN_MS);
     
     resetStatistics();
     
@@ -88,7 +89,7 @@ void HeaterControl::updateControl(int16_t currentTemp, int16_t targetTemp, const
 
 void HeaterControl::updatePIDControl(int16_t currentTemp, int16_t targetTemp) {
     pidInput = (double)currentTemp / 10.0; // Convert int16_t to double for PID
-    pidSetpoint = targetTemp; // pidSetpoint is already int16_t
+    pidSetpoint = (double)targetTemp / 10.0; // Même unité que pidInput
     
     if (pidController->Compute()) {
         currentOutput = (float)pidOutput;
@@ -100,7 +100,7 @@ private:
     static PID* pidController;
     static int pin;
     static double pidInput, pidOutput; // pidInput sera converti de int16_t à double
-    static int16_t pidSetpoint; // Changé en int16_t
+    static double pidSetpoint; // Consigne en °C (le PID lit un double)
     static float currentOutput;
     static int16_t hysteresisValue; // Changé en int16_t
     static bool pidMode;
@@ -0,0 +1,304 @@
+#include "MotionRecorder.h"
+#include "../utils/Logger.h"
+#include "img_converters.h"
+#include <LittleFS.h>
+#include <vector>
+
+using namespace MotionConstants;
+
+// Forward declaration (main.cpp)
+SystemConfig& getGlobalConfig();
+
+static const char* EVENTS_DIR = "/events";
+static const char* INDEX_PATH = "/events/index.bin";
+static const char* INDEX_TEMP_PATH = "/events/index.tmp";
+
+// Variables statiques
+MotionEvent MotionRecorder::events[MotionConstants::MAX_EVENTS];
+uint16_t MotionRecorder::eventCount = 0;
+uint32_t MotionRecorder::storedBytes = 0;
+uint32_t MotionRecorder::nextId = 1;
+portMUX_TYPE MotionRecorder::eventMux = portMUX_INITIALIZER_UNLOCKED;
+TaskHandle_t MotionRecorder::task = NULL;
+int16_t MotionRecorder::background[MotionRecorder::GRID_CELLS];
+uint8_t MotionRecorder::warmup = MotionConstants::WARMUP_FRAMES;
+uint16_t MotionRecorder::frameWidth = 0;
+uint8_t* MotionRecorder::decoded = nullptr;
+size_t MotionRecorder::decodedCapacity = 0;
+volatile uint16_t MotionRecorder::cpuPermille = 0;
+
+bool MotionRecorder::begin() {
+    if (!LittleFS.exists(EVENTS_DIR)) {
+        LittleFS.mkdir(EVENTS_DIR);
+    }
+    File dir = LittleFS.open(EVENTS_DIR);
+    if (!dir || !dir.isDirectory()) {
+        LOG_ERROR("MOTION", "Répertoire %s inaccessible", EVENTS_DIR);
+        return false;
+    }
+    dir.close();
+
+    loadIndex();
+    removeOrphans();
+    LOG_INFO("MOTION", "%u événements enregistrés (%lu octets)", eventCount, (unsigned long)storedBytes);
+
+    xTaskCreatePinnedToCore(taskLoop, "Motion", TASK_STACK, NULL, TASK_PRIORITY, &task, TASK_CORE);
+    if (task == NULL) {
+        LOG_ERROR("MOTION", "Impossible de créer la tâche de détection");
+        return false;
+    }
+    return true;
+}
+
+size_t MotionRecorder::getEvents(MotionEvent* out, size_t maxCount) {
+    portENTER_CRITICAL(&eventMux);
+    size_t count = min((size_t)eventCount, maxCount);
+    memcpy(out, events, count * sizeof(MotionEvent));
+    portEXIT_CRITICAL(&eventMux);
+    return count;
+}
+
+uint32_t MotionRecorder::getStoredBytes() {
+    portENTER_CRITICAL(&eventMux);
+    uint32_t bytes = storedBytes;
+    portEXIT_CRITICAL(&eventMux);
+    return bytes;
+}
+
+String MotionRecorder::framePath(uint32_t id, uint16_t frame) {
+    char path[40];
+    snprintf(path, sizeof(path), "%s/%08lu-%u.jpg", EVENTS_DIR, (unsigned long)id, frame);
+    return String(path);
+}
+
+// === Analyse ===
+
+void MotionRecorder::taskLoop(void* arg) {
+    unsigned long lastEvent = 0;
+    bool recorded = false;
+    for (;;) {
+        if (!CameraManager::initialized || !getGlobalConfig().motionRecording) {
+            warmup = WARMUP_FRAMES;
+            cpuPermille = 0;
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            continue;
+        }
+
+        // Sans flux ouvert, snapshot() capture et copie l'image : ce coût
+        // fait partie de l'analyse et entre dans le budget CPU
+        uint32_t interval = ANALYSIS_INTERVAL_MS;
+        unsigned long start = micros();
+        CameraFrame* frame = CameraManager::snapshot();
+        if (frame) {
+            uint16_t score = 0;
+            bool measured = measure(frame, score);
+            unsigned long elapsed = micros() - start;
+
+            // Budget CPU : elapsed µs sur interval ms font elapsed / interval ‰
+            interval = max(interval, (uint32_t)(elapsed / CPU_BUDGET_PERMILLE));
+            cpuPermille = (uint16_t)min(1000UL, elapsed / interval);
+
+            if (measured && score >= TRIGGER_PERMILLE &&
+                (!recorded || millis() - lastEvent >= COOLDOWN_MS)) {
+                recordBurst(frame, score);   // Rend frame dès qu'elle est écrite
+                frame = nullptr;
+                lastEvent = millis();
+                recorded = true;
+            }
+            CameraManager::releaseFrame(frame);
+        }
+        vTaskDelay(pdMS_TO_TICKS(interval));
+    }
+}
+
+bool MotionRecorder::measure(const CameraFrame* frame, uint16_t& score) {
+    // Au 1/8, tjpgd ne calcule que le coefficient DC de chaque bloc 8x8
+    size_t width = (frame->width + 7) / 8;
+    size_t height = (frame->height + 7) / 8;
+    size_t bytes = width * height * 2;
+    if (width == 0 || height == 0) return false;
+    if (decodedCapacity < bytes) {
+        free(decoded);
+        decoded = (uint8_t*)ps_malloc(bytes);
+        if (!decoded) decoded = (uint8_t*)malloc(bytes);
+        decodedCapacity = decoded ? bytes : 0;
+        if (!decoded) return false;
+    }
+    if (!jpg2rgb565(frame->data, frame->length, decoded, JPG_SCALE_8X)) return false;
+
+    // Luminance moyenne de chaque cellule de la grille
+    uint32_t sums[GRID_CELLS] = {};
+    uint16_t counts[GRID_CELLS] = {};
+    const uint8_t* pixel = decoded;
+    for (size_t y = 0; y < height; y++) {
+        int row = y * GRID_ROWS / height;
+        for (size_t x = 0; x < width; x++, pixel += 2) {
+            uint16_t c = (pixel[0] << 8) | pixel[1];     // RGB565, octet fort en premier
+            uint32_t luma = ((c >> 11) * 8 * 77 + ((c >> 5) & 0x3F) * 4 * 150 + (c & 0x1F) * 8 * 29) >> 8;
+            int cell = row * GRID_COLS + x * GRID_COLS / width;
+            sums[cell] += luma;
+            counts[cell]++;
+        }
+    }
+
+    // Une autre résolution change la grille : le fond est repris à zéro
+    if (frame->width != frameWidth) {
+        frameWidth = frame->width;
+        warmup = WARMUP_FRAMES;
+    }
+    bool reset = warmup == WARMUP_FRAMES;
+    uint16_t changed = 0;
+    for (int cell = 0; cell < GRID_CELLS; cell++) {
+        if (counts[cell] == 0) continue;
+        int16_t value = (int16_t)(sums[cell] * 16 / counts[cell]);
+        if (reset) {
+            background[cell] = value;
+            continue;
+        }
+        if (abs(value - background[cell]) > CELL_THRESHOLD * 16) changed++;
+        background[cell] += (value - background[cell]) >> BACKGROUND_SHIFT;
+    }
+    if (warmup > 0) {
+        warmup--;
+        score = 0;
+    } else {
+        score = changed * 1000 / GRID_CELLS;
+    }
+    return true;
+}
+
+// === Enregistrement ===
+
+void MotionRecorder::recordBurst(CameraFrame* first, uint16_t score) {
+    MotionEvent event = { nextId++, (uint32_t)time(nullptr), 0, score, 0 };
+    uint32_t lastSequence = first->sequence;
+    saveFrame(event, first);
+    // Le reste de la rafale dure plusieurs secondes : l'emplacement est rendu
+    CameraManager::releaseFrame(first);
+    for (uint8_t i = 1; i < BURST_FRAMES; i++) {
+        vTaskDelay(pdMS_TO_TICKS(BURST_INTERVAL_MS));
+        CameraFrame* frame = CameraManager::snapshot();
+        if (!frame) continue;
+        if (frame->sequence != lastSequence) {
+            lastSequence = frame->sequence;
+            saveFrame(event, frame);
+        }
+        CameraManager::releaseFrame(frame);
+    }
+    if (event.frames == 0) return;
+
+    if (eventCount == MAX_EVENTS) evictOldest();
+    portENTER_CRITICAL(&eventMux);
+    events[eventCount++] = event;
+    storedBytes += event.bytes;
+    portEXIT_CRITICAL(&eventMux);
+    while (storedBytes > MAX_BYTES && eventCount > 1) {
+        evictOldest();
+    }
+    saveIndex();
+    LOG_INFO("MOTION", "Événement %lu : %u images, %lu octets (score %u ‰)",
+             (unsigned long)event.id, event.frames, (unsigned long)event.bytes, score);
+}
+
+bool MotionRecorder::saveFrame(MotionEvent& event, const CameraFrame* frame) {
+    // Les événements les plus anciens laissent la place au nouveau
+    while (eventCount > 0 && LittleFS.totalBytes() - LittleFS.usedBytes() < frame->length + FS_RESERVE_BYTES) {
+        evictOldest();
+    }
+    if (LittleFS.totalBytes() - LittleFS.usedBytes() < frame->length + FS_RESERVE_BYTES) {
+        LOG_WARN("MOTION", "LittleFS plein, image ignorée");
+        return false;
+    }
+    String path = framePath(event.id, event.frames);
+    File file = LittleFS.open(path, "w");
+    if (!file) return false;
+    size_t written = file.write(frame->data, frame->length);
+    file.close();
+    if (written != frame->length) {
+        LittleFS.remove(path);
+        return false;
+    }
+    event.frames++;
+    event.bytes += frame->length;
+    return true;
+}
+
+void MotionRecorder::evictOldest() {
+    if (eventCount == 0) return;
+    portENTER_CRITICAL(&eventMux);
+    MotionEvent oldest = events[0];
+    memmove(events, events + 1, (eventCount - 1) * sizeof(MotionEvent));
+    eventCount--;
+    storedBytes -= oldest.bytes;
+    portEXIT_CRITICAL(&eventMux);
+    for (uint16_t frame = 0; frame < oldest.frames; frame++) {
+        LittleFS.remove(framePath(oldest.id, frame));
+    }
+}
+
+// === Index ===
+
+void MotionRecorder::loadIndex() {
+    // nextId, puis les événements : un identifiant n'est jamais réutilisé,
+    // même une fois tous les événements supprimés
+    File file = LittleFS.open(INDEX_PATH, "r");
+    if (!file) return;
+    if (file.read((uint8_t*)&nextId, sizeof(nextId)) != sizeof(nextId) || nextId == 0) {
+        nextId = 1;
+    }
+    MotionEvent event;
+    while (eventCount < MAX_EVENTS && file.read((uint8_t*)&event, sizeof(event)) == sizeof(event)) {
+        if (event.frames == 0 || event.frames > BURST_FRAMES || event.id >= nextId) break;
+        events[eventCount++] = event;
+        storedBytes += event.bytes;
+    }
+    file.close();
+}
+
+bool MotionRecorder::saveIndex() {
+    // Seule cette tâche modifie events : pas de copie sous verrou ici
+    File file = LittleFS.open(INDEX_TEMP_PATH, "w");
+    if (!file) return false;
+    size_t bytes = eventCount * sizeof(MotionEvent);
+    bool ok = file.write((const uint8_t*)&nextId, sizeof(nextId)) == sizeof(nextId) &&
+              file.write((const uint8_t*)events, bytes) == bytes;
+    file.close();
+    if (!ok || !LittleFS.rename(INDEX_TEMP_PATH, INDEX_PATH)) {
+        LOG_ERROR("MOTION", "Écriture de l'index impossible");
+        LittleFS.remove(INDEX_TEMP_PATH);
+        return false;
+    }
+    return true;
+}
+
+void MotionRecorder::removeOrphans() {
+    // Images d'une rafale interrompue avant l'écriture de l'index
+    std::vector<String> orphans;
+    File dir = LittleFS.open(EVENTS_DIR);
+    for (File file = dir.openNextFile(); file; file = dir.openNextFile()) {
+        const char* name = file.name();
+        const char* slash = strrchr(name, '/');
+        const char* base = slash ? slash + 1 : name;
+        file.close();
+        char* end;
+        uint32_t id = strtoul(base, &end, 10);
+        if (*end == '-') {
+            unsigned long frame = strtoul(end + 1, &end, 10);
+            bool known = false;
+            for (uint16_t i = 0; i < eventCount && !known; i++) {
+                known = events[i].id == id && frame < events[i].frames;
+            }
+            if (known && strcmp(end, ".jpg") == 0) continue;
+        } else if (strcmp(base, "index.bin") == 0) {
+            continue;
+        }
+        orphans.push_back(String(EVENTS_DIR) + "/" + base);
+    }
+    dir.close();
+    for (const String& path : orphans) {
+        LittleFS.remove(path);
+    }
+    if (!orphans.empty()) {
+        LOG_WARN("MOTION", "%u fichiers orphelins supprimés", (unsigned)orphans.size());
+    }
+}
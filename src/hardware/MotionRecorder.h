@@ -0,0 +1,90 @@
+#ifndef MOTION_RECORDER_H
+#define MOTION_RECORDER_H
+
+#include "../config/SystemConfig.h"
+#include "CameraManager.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Entrée de /events/index.bin, qui commence par le prochain identifiant
+// (uint32_t) : un événement et ses images /events/<id>-<n>.jpg (n de 0 à
+// frames - 1).
+struct MotionEvent {
+    uint32_t id;
+    uint32_t time;            // Heure Unix du déclenchement
+    uint16_t frames;          // Images enregistrées
+    uint16_t score;           // Part des cellules changées au déclenchement (‰)
+    uint32_t bytes;           // Taille totale des images
+};
+
+// La classe MotionRecorder surveille la caméra à basse cadence, dans une
+// tâche de faible priorité sur le cœur 0. Chaque analyse décode l'image au
+// 1/8 (le décodeur ne garde alors que les coefficients DC des blocs JPEG),
+// la réduit à une grille de luminance et la compare à un fond qui suit
+// lentement les variations d'éclairage. Un mouvement enregistre une rafale
+// de JPEG dans /events ; au-delà de MAX_BYTES ou MAX_EVENTS, les événements
+// les plus anciens sont supprimés. La durée de chaque analyse est mesurée et
+// l'intervalle s'allonge si elle dépasse CPU_BUDGET_PERMILLE d'un cœur.
+//
+// La détection ne tourne que si config.motionRecording est vrai et que la
+// caméra est initialisée.
+class MotionRecorder {
+public:
+    /**
+     * @brief Relit l'index des événements et lance la tâche d'analyse
+     * (LittleFS doit être monté).
+     * @return true si le répertoire des événements est accessible, false sinon.
+     */
+    static bool begin();
+
+    /**
+     * @brief Copie les événements enregistrés, du plus ancien au plus récent.
+     * @param out Tableau de destination.
+     * @param maxCount Taille de out.
+     * @return Le nombre d'événements copiés.
+     */
+    static size_t getEvents(MotionEvent* out, size_t maxCount);
+
+    /**
+     * @brief Renvoie la taille totale des images enregistrées.
+     */
+    static uint32_t getStoredBytes();
+
+    /**
+     * @brief Renvoie la part d'un cœur prise par la dernière analyse (‰).
+     */
+    static uint16_t getCpuPermille() { return cpuPermille; }
+
+    /**
+     * @brief Renvoie le chemin d'une image d'événement.
+     */
+    static String framePath(uint32_t id, uint16_t frame);
+
+private:
+    static const int GRID_CELLS = MotionConstants::GRID_COLS * MotionConstants::GRID_ROWS;
+
+    static MotionEvent events[MotionConstants::MAX_EVENTS];   // Du plus ancien au plus récent
+    static uint16_t eventCount;
+    static uint32_t storedBytes;
+    static uint32_t nextId;
+    static portMUX_TYPE eventMux;
+    static TaskHandle_t task;
+
+    static int16_t background[GRID_CELLS];    // Luminance x 16 de chaque cellule
+    static uint8_t warmup;
+    static uint16_t frameWidth;
+    static uint8_t* decoded;                  // Image RGB565 au 1/8, en PSRAM
+    static size_t decodedCapacity;
+    static volatile uint16_t cpuPermille;
+
+    static void taskLoop(void* arg);
+    static bool measure(const CameraFrame* frame, uint16_t& score);
+    static void recordBurst(CameraFrame* first, uint16_t score);   // Prend la référence de first
+    static bool saveFrame(MotionEvent& event, const CameraFrame* frame);
+    static void evictOldest();
+    static void loadIndex();
+    static bool saveIndex();
+    static void removeOrphans();
+};
+
+#endif // MOTION_RECORDER_H
@@ -0,0 +1,383 @@
+#include "Timelapse.h"
+#include "../utils/Logger.h"
+#include <LittleFS.h>
+#include <algorithm>
+#include <memory>
+
+using namespace TimelapseConstants;
+
+static const char* TIMELAPSE_DIR = "/timelapse";
+
+// Variables statiques
+TimelapseDay Timelapse::days[TimelapseConstants::MAX_DAYS];
+uint16_t Timelapse::dayCount = 0;
+uint32_t Timelapse::storedBytes = 0;
+portMUX_TYPE Timelapse::dayMux = portMUX_INITIALIZER_UNLOCKED;
+QueueHandle_t Timelapse::queue = NULL;
+TaskHandle_t Timelapse::writerTask = NULL;
+bool Timelapse::started = false;
+uint32_t Timelapse::lastSlot = 0;
+volatile uint32_t Timelapse::droppedFrames = 0;
+
+namespace {
+    // Nom de base d'une entrée de répertoire (name() renvoie le chemin
+    // complet sur les anciennes versions du cœur)
+    const char* baseName(File& file) {
+        const char* name = file.name();
+        const char* slash = strrchr(name, '/');
+        return slash ? slash + 1 : name;
+    }
+
+    // Position d'un téléchargement de jour : en-tête de partie, JPEG lu
+    // directement dans le tampon de la réponse, "\r\n" de fin de partie
+    struct DayCursor {
+        String dir;
+        std::vector<Timelapse::FrameFile> frames;
+        bool multipart = false;
+        size_t next = 0;              // Prochaine image à ouvrir
+        File file;
+        size_t remaining = 0;         // Octets du JPEG en cours
+        String prefix;                // Texte à envoyer avant la suite
+        size_t prefixSent = 0;
+        bool closed = false;          // Délimiteur final envoyé
+
+        static String partHeader(const Timelapse::FrameFile& frame) {
+            return "--frame\r\nContent-Type: image/jpeg\r\nContent-Disposition: inline; filename=\"" +
+                   frame.name + "\"\r\nContent-Length: " + String((unsigned long)frame.size) + "\r\n\r\n";
+        }
+
+        size_t totalLength() const {
+            size_t length = 0;
+            for (const Timelapse::FrameFile& frame : frames) {
+                length += frame.size;
+                if (multipart) length += partHeader(frame).length() + 2;
+            }
+            return multipart ? length + strlen("--frame--\r\n") : length;
+        }
+
+        size_t fill(uint8_t* buffer, size_t maxLen) {
+            size_t written = 0;
+            while (written < maxLen) {
+                if (prefixSent < prefix.length()) {
+                    size_t count = min(maxLen - written, (size_t)(prefix.length() - prefixSent));
+                    memcpy(buffer + written, prefix.c_str() + prefixSent, count);
+                    prefixSent += count;
+                    written += count;
+                    continue;
+                }
+                if (remaining > 0) {
+                    size_t count = min(maxLen - written, remaining);
+                    size_t read = file ? file.read(buffer + written, count) : 0;
+                    // Image supprimée ou tronquée entre-temps : la longueur
+                    // annoncée est tenue avec des zéros
+                    if (read == 0) {
+                        memset(buffer + written, 0, count);
+                        read = count;
+                    }
+                    remaining -= read;
+                    written += read;
+                    if (remaining == 0) {
+                        file.close();
+                        prefix = multipart ? "\r\n" : "";
+                        prefixSent = 0;
+                    }
+                    continue;
+                }
+                if (next < frames.size()) {
+                    const Timelapse::FrameFile& frame = frames[next++];
+                    file = LittleFS.open(dir + "/" + frame.name, "r");
+                    remaining = frame.size;
+                    prefix = multipart ? partHeader(frame) : "";
+                    prefixSent = 0;
+                    continue;
+                }
+                if (multipart && !closed) {
+                    prefix = "--frame--\r\n";
+                    prefixSent = 0;
+                    closed = true;
+                    continue;
+                }
+                break;
+            }
+            return written;
+        }
+    };
+}
+
+bool Timelapse::begin() {
+    if (!LittleFS.exists(TIMELAPSE_DIR)) {
+        LittleFS.mkdir(TIMELAPSE_DIR);
+    }
+    File root = LittleFS.open(TIMELAPSE_DIR);
+    if (!root || !root.isDirectory()) {
+        LOG_ERROR("TIMELAPSE", "Répertoire %s inaccessible", TIMELAPSE_DIR);
+        return false;
+    }
+
+    // Jours présents (répertoires "AAAAMMJJ") et taille de leurs images
+    std::vector<TimelapseDay> found;
+    for (File entry = root.openNextFile(); entry; entry = root.openNextFile()) {
+        char* end;
+        uint32_t date = strtoul(baseName(entry), &end, 10);
+        bool isDay = entry.isDirectory() && *end == '\0' && date >= 19700101;
+        entry.close();
+        if (!isDay) continue;
+        std::vector<FrameFile> frames;
+        listFrames(date, frames);
+        TimelapseDay day = { date, 0, 0 };
+        for (const FrameFile& frame : frames) {
+            day.frames++;
+            day.bytes += frame.size;
+        }
+        found.push_back(day);
+    }
+    root.close();
+    std::sort(found.begin(), found.end(),
+              [](const TimelapseDay& a, const TimelapseDay& b) { return a.date < b.date; });
+
+    size_t skip = found.size() > MAX_DAYS ? found.size() - MAX_DAYS : 0;
+    for (size_t i = 0; i < found.size(); i++) {
+        if (i < skip) {
+            // Au-delà de MAX_DAYS : les jours les plus anciens disparaissent
+            std::vector<FrameFile> frames;
+            listFrames(found[i].date, frames);
+            for (const FrameFile& frame : frames) {
+                LittleFS.remove(dayPath(found[i].date) + "/" + frame.name);
+            }
+            LittleFS.rmdir(dayPath(found[i].date));
+            continue;
+        }
+        days[dayCount++] = found[i];
+        storedBytes += found[i].bytes;
+    }
+    LOG_INFO("TIMELAPSE", "%u jours enregistrés (%lu octets)", dayCount, (unsigned long)storedBytes);
+
+    queue = xQueueCreate(STAGING_FRAMES, sizeof(StagedFrame));
+    if (queue != NULL) {
+        xTaskCreatePinnedToCore(writerLoop, "Timelapse", WRITER_STACK, NULL, WRITER_PRIORITY, &writerTask, WRITER_CORE);
+    }
+    if (writerTask == NULL) {
+        // Sans tâche d'écriture, process() écrit elle-même
+        LOG_WARN("TIMELAPSE", "Tâche d'écriture indisponible, écriture synchrone");
+        if (queue != NULL) vQueueDelete(queue);
+        queue = NULL;
+    }
+    started = true;
+    return true;
+}
+
+// === Capture (tâche principale) ===
+
+void Timelapse::process(const SystemConfig& config) {
+    if (!started || config.timelapseMinutes == 0 || !CameraManager::initialized) return;
+    struct tm local;
+    if (!getLocalTime(&local, 0)) return;   // Heure pas encore synchronisée
+
+    // Une image par créneau de timelapseMinutes, aligné sur l'horloge
+    time_t now = time(nullptr);
+    uint32_t slot = (uint32_t)(now / (config.timelapseMinutes * 60UL));
+    if (slot == lastSlot) return;
+    lastSlot = slot;
+
+    CameraFrame* frame = CameraManager::snapshot();
+    if (!frame) {
+        LOG_WARN("TIMELAPSE", "Capture impossible");
+        return;
+    }
+    // Copie en PSRAM : l'emplacement partagé est rendu avant l'écriture
+    StagedFrame staged = { (uint8_t*)ps_malloc(frame->length), frame->length, (uint32_t)now };
+    if (!staged.data) staged.data = (uint8_t*)malloc(frame->length);
+    if (staged.data) memcpy(staged.data, frame->data, frame->length);
+    CameraManager::releaseFrame(frame);
+
+    if (staged.data && queue == NULL) {
+        write(staged);
+        free(staged.data);
+        return;
+    }
+    if (!staged.data || xQueueSend(queue, &staged, 0) != pdTRUE) {
+        free(staged.data);
+        droppedFrames++;
+        LOG_WARN("TIMELAPSE", "File d'écriture pleine, image abandonnée");
+    }
+}
+
+// === Écriture (tâche de fond) ===
+
+void Timelapse::writerLoop(void* arg) {
+    StagedFrame staged;
+    for (;;) {
+        if (xQueueReceive(queue, &staged, portMAX_DELAY) != pdTRUE) continue;
+        write(staged);
+        free(staged.data);
+    }
+}
+
+void Timelapse::write(const StagedFrame& staged) {
+    time_t t = staged.time;
+    struct tm local;
+    localtime_r(&t, &local);
+    uint32_t date = (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
+
+    if (storedBytes + staged.length > MAX_BYTES) {
+        evict(storedBytes + staged.length - EVICT_TARGET_BYTES);
+    }
+    while (dayCount > 0 && LittleFS.totalBytes() - LittleFS.usedBytes() < staged.length + FS_RESERVE_BYTES) {
+        evict(staged.length);
+    }
+    if (LittleFS.totalBytes() - LittleFS.usedBytes() < staged.length + FS_RESERVE_BYTES) {
+        droppedFrames++;
+        LOG_WARN("TIMELAPSE", "LittleFS plein, image abandonnée");
+        return;
+    }
+
+    String dir = dayPath(date);
+    if (!LittleFS.exists(dir)) LittleFS.mkdir(dir);
+    char name[16];
+    snprintf(name, sizeof(name), "/%02d%02d%02d.jpg", local.tm_hour, local.tm_min, local.tm_sec);
+    String path = dir + name;
+    File file = LittleFS.open(path, "w");
+    size_t written = file ? file.write(staged.data, staged.length) : 0;
+    if (file) file.close();
+    if (written != staged.length) {
+        LittleFS.remove(path);
+        droppedFrames++;
+        LOG_ERROR("TIMELAPSE", "Écriture de %s impossible", path.c_str());
+        return;
+    }
+    addFrame(date, staged.length);
+}
+
+void Timelapse::addFrame(uint32_t date, uint32_t bytes) {
+    // Place du jour dans la liste triée (le plus souvent : le dernier)
+    uint16_t index = dayCount;
+    while (index > 0 && days[index - 1].date >= date) index--;
+    if (index == dayCount || days[index].date != date) {
+        if (dayCount == MAX_DAYS) {
+            evictOldest(UINT32_MAX);              // Le jour le plus ancien entier
+            if (index > 0) index--;
+        }
+        portENTER_CRITICAL(&dayMux);
+        memmove(days + index + 1, days + index, (dayCount - index) * sizeof(TimelapseDay));
+        days[index] = TimelapseDay{ date, 0, 0 };
+        dayCount++;
+        portEXIT_CRITICAL(&dayMux);
+    }
+    portENTER_CRITICAL(&dayMux);
+    days[index].frames++;
+    days[index].bytes += bytes;
+    storedBytes += bytes;
+    portEXIT_CRITICAL(&dayMux);
+}
+
+void Timelapse::evict(uint32_t bytes) {
+    // Les images les plus anciennes d'abord, un répertoire de jour à la fois
+    uint32_t freed = 0;
+    while (freed < bytes && dayCount > 0) {
+        freed += evictOldest(bytes - freed);
+    }
+}
+
+uint32_t Timelapse::evictOldest(uint32_t bytes) {
+    uint32_t date = days[0].date;
+    String dir = dayPath(date);
+    std::vector<FrameFile> frames;
+    listFrames(date, frames);
+    uint16_t removed = 0;
+    uint32_t freed = 0;
+    for (const FrameFile& frame : frames) {
+        if (freed >= bytes) break;
+        LittleFS.remove(dir + "/" + frame.name);
+        removed++;
+        freed += frame.size;
+    }
+
+    // Jour vidé (ou répertoire disparu) : il quitte la liste
+    bool emptied = removed == frames.size();
+    portENTER_CRITICAL(&dayMux);
+    uint32_t released = emptied ? days[0].bytes : min(days[0].bytes, freed);
+    storedBytes -= min(storedBytes, released);
+    if (emptied) {
+        memmove(days, days + 1, (dayCount - 1) * sizeof(TimelapseDay));
+        dayCount--;
+    } else {
+        days[0].frames -= min(days[0].frames, removed);
+        days[0].bytes -= released;
+    }
+    portEXIT_CRITICAL(&dayMux);
+    if (emptied) LittleFS.rmdir(dir);
+    return freed;
+}
+
+// === Consultation ===
+
+size_t Timelapse::getDays(TimelapseDay* out, size_t maxCount) {
+    portENTER_CRITICAL(&dayMux);
+    size_t count = min((size_t)dayCount, maxCount);
+    memcpy(out, days, count * sizeof(TimelapseDay));
+    portEXIT_CRITICAL(&dayMux);
+    return count;
+}
+
+uint32_t Timelapse::getStoredBytes() {
+    portENTER_CRITICAL(&dayMux);
+    uint32_t bytes = storedBytes;
+    portEXIT_CRITICAL(&dayMux);
+    return bytes;
+}
+
+String Timelapse::dayPath(uint32_t date) {
+    char path[24];
+    snprintf(path, sizeof(path), "%s/%08lu", TIMELAPSE_DIR, (unsigned long)date);
+    return String(path);
+}
+
+bool Timelapse::listFrames(uint32_t date, std::vector<FrameFile>& frames) {
+    File dir = LittleFS.open(dayPath(date));
+    if (!dir || !dir.isDirectory()) return false;
+    for (File file = dir.openNextFile(); file; file = dir.openNextFile()) {
+        if (!file.isDirectory()) {
+            frames.push_back(FrameFile{ String(baseName(file)), (uint32_t)file.size() });
+        }
+        file.close();
+    }
+    dir.close();
+    // HHMMSS.jpg : l'ordre des noms est l'ordre chronologique
+    std::sort(frames.begin(), frames.end(),
+              [](const FrameFile& a, const FrameFile& b) { return strcmp(a.name.c_str(), b.name.c_str()) < 0; });
+    return true;
+}
+
+void Timelapse::handleDay(AsyncWebServerRequest *request) {
+    if (!request->hasParam("date")) {
+        request->send(400, "text/plain", "Paramètre 'date' manquant (AAAAMMJJ)");
+        return;
+    }
+    uint32_t date = (uint32_t)request->getParam("date")->value().toInt();
+    String format = request->hasParam("format") ? request->getParam("format")->value() : "mjpeg";
+    if (format != "mjpeg" && format != "multipart") {
+        request->send(400, "text/plain", "Format invalide (mjpeg ou multipart)");
+        return;
+    }
+
+    std::shared_ptr<DayCursor> cursor = std::make_shared<DayCursor>();
+    cursor->multipart = format == "multipart";
+    cursor->dir = dayPath(date);
+    if (!listFrames(date, cursor->frames) || cursor->frames.empty()) {
+        request->send(404, "text/plain", "Aucune image pour ce jour");
+        return;
+    }
+
+    // Longueur connue d'avance : les fichiers sont lus au fil de l'envoi
+    AsyncWebServerResponse *response = request->beginResponse(
+        cursor->multipart ? "multipart/mixed; boundary=frame" : "video/x-motion-jpeg",
+        cursor->totalLength(),
+        [cursor](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+            return cursor->fill(buffer, maxLen);
+        });
+    char disposition[64];
+    snprintf(disposition, sizeof(disposition), "attachment; filename=\"timelapse-%08lu.%s\"",
+             (unsigned long)date, cursor->multipart ? "multipart" : "mjpeg");
+    response->addHeader("Content-Disposition", disposition);
+    request->send(response);
+}
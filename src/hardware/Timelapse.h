@@ -0,0 +1,98 @@
+#ifndef TIMELAPSE_H
+#define TIMELAPSE_H
+
+#include "../config/SystemConfig.h"
+#include "CameraManager.h"
+#include <ESPAsyncWebServer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <vector>
+
+// Un jour du time-lapse : /timelapse/AAAAMMJJ/HHMMSS.jpg
+struct TimelapseDay {
+    uint32_t date;            // AAAAMMJJ, heure locale
+    uint16_t frames;
+    uint32_t bytes;
+};
+
+// La classe Timelapse prend une image toutes les config.timelapseMinutes
+// minutes, alignées sur l'horloge (10:00, 10:05...). process(), appelée par
+// la tâche principale, ne fait que copier l'image en PSRAM et la mettre en
+// file : l'écriture sur LittleFS, et donc sa latence, reste dans une tâche
+// de faible priorité sur le cœur 0. Au-delà de MAX_BYTES, les images les
+// plus anciennes sont supprimées par lots jusqu'à EVICT_TARGET_BYTES.
+//
+// Un jour se télécharge d'un bloc, soit en MJPEG (JPEG concaténés), soit
+// en multipart/mixed, fichier par fichier sans tout charger en mémoire.
+class Timelapse {
+public:
+    /**
+     * @brief Recense les jours enregistrés et lance la tâche d'écriture
+     * (LittleFS doit être monté).
+     * @return true si le répertoire du time-lapse est accessible, false sinon.
+     */
+    static bool begin();
+
+    /**
+     * @brief Prend une image si l'intervalle est écoulé (tâche principale).
+     * Sans heure valide (NTP non synchronisé), aucune image n'est prise.
+     * @param config La configuration (timelapseMinutes, 0 : désactivé).
+     */
+    static void process(const SystemConfig& config);
+
+    /**
+     * @brief Copie la liste des jours, du plus ancien au plus récent.
+     * @return Le nombre de jours copiés.
+     */
+    static size_t getDays(TimelapseDay* out, size_t maxCount);
+
+    static uint32_t getStoredBytes();
+    static uint32_t getDroppedFrames() { return droppedFrames; }
+
+    /**
+     * @brief Télécharge un jour : GET /api/timelapse/day?date=AAAAMMJJ&format=mjpeg|multipart
+     * @param request Pointeur vers l'objet de la requête web.
+     */
+    static void handleDay(AsyncWebServerRequest *request);
+
+    // Image d'un jour sur LittleFS (nom "HHMMSS.jpg")
+    struct FrameFile {
+        String name;
+        uint32_t size;
+    };
+
+    /**
+     * @brief Liste les images d'un jour, dans l'ordre chronologique.
+     * @return false si le jour n'existe pas.
+     */
+    static bool listFrames(uint32_t date, std::vector<FrameFile>& frames);
+
+    static String dayPath(uint32_t date);
+
+private:
+    // Image en attente d'écriture ; data (PSRAM) est libérée par la tâche d'écriture
+    struct StagedFrame {
+        uint8_t* data;
+        size_t length;
+        uint32_t time;
+    };
+
+    static TimelapseDay days[TimelapseConstants::MAX_DAYS];   // Du plus ancien au plus récent
+    static uint16_t dayCount;
+    static uint32_t storedBytes;
+    static portMUX_TYPE dayMux;
+    static QueueHandle_t queue;
+    static TaskHandle_t writerTask;
+    static bool started;
+    static uint32_t lastSlot;
+    static volatile uint32_t droppedFrames;
+
+    static void writerLoop(void* arg);
+    static void write(const StagedFrame& staged);
+    static void addFrame(uint32_t date, uint32_t bytes);
+    static void evict(uint32_t bytes);
+    static uint32_t evictOldest(uint32_t bytes);
+};
+
+#endif // TIMELAPSE_H
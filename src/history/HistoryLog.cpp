@@ -0,0 +1,141 @@
+#include "HistoryLog.h"
+#include "../utils/Logger.h"
+
+using namespace HistoryConstants;
+
+// Variables statiques
+PackedHistoryRecord* HistoryLog::records = nullptr;
+uint32_t* HistoryLog::blockStart = nullptr;
+uint32_t HistoryLog::blockCount = 0;
+std::atomic<uint32_t> HistoryLog::head{0};
+std::atomic<uint32_t> HistoryLog::writing{0};
+uint32_t HistoryLog::currentBlockStart = 0;
+
+bool HistoryLog::initialize() {
+    if (records) return true;
+
+    uint32_t blocks = PSRAM_BLOCKS;
+    records = (PackedHistoryRecord*)ps_malloc(blocks * BLOCK_RECORDS * sizeof(PackedHistoryRecord));
+    blockStart = (uint32_t*)ps_malloc(blocks * sizeof(uint32_t));
+    if (!records || !blockStart) {
+        free(records);
+        free(blockStart);
+        blocks = FALLBACK_BLOCKS;
+        records = (PackedHistoryRecord*)malloc(blocks * BLOCK_RECORDS * sizeof(PackedHistoryRecord));
+        blockStart = (uint32_t*)malloc(blocks * sizeof(uint32_t));
+        if (!records || !blockStart) {
+            free(records);
+            free(blockStart);
+            records = nullptr;
+            blockStart = nullptr;
+            LOG_ERROR("HISTORY", "Échec allocation de l'historique");
+            return false;
+        }
+        LOG_WARN("HISTORY", "PSRAM indisponible : historique limité à %lu blocs", (unsigned long)blocks);
+    }
+
+    blockCount = blocks;
+    head.store(0);
+    writing.store(0);
+    LOG_INFO("HISTORY", "Historique : %lu enregistrements (%lu Ko)", (unsigned long)getCapacity(),
+             (unsigned long)((getCapacity() * sizeof(PackedHistoryRecord) + blocks * sizeof(uint32_t)) / 1024));
+    return true;
+}
+
+void HistoryLog::append(uint32_t timestamp, int16_t temperature, float humidity, uint8_t heaterDuty) {
+    if (!records) return;
+    // Heure pas encore synchronisée (NTP) : un bloc daté de 1970 casserait
+    // l'ordre croissant des blocs dont dépend findFirst()
+    if (timestamp < MIN_VALID_TIMESTAMP) return;
+
+    PackedHistoryRecord record;
+    record.offsetSeconds = 0;
+    record.temperature = temperature;
+    record.humidity = isnan(humidity) ? HISTORY_UNKNOWN_HUMIDITY : (uint8_t)constrain(lroundf(humidity), 0L, 100L);
+    record.heaterDuty = heaterDuty;
+
+    // Horloge recalée (NTP) ou décalage non représentable : nouveau bloc
+    uint32_t count = head.load(std::memory_order_relaxed);
+    if (count % BLOCK_RECORDS != 0 &&
+        (timestamp < currentBlockStart || timestamp - currentBlockStart >= HISTORY_EMPTY_SLOT)) {
+        PackedHistoryRecord empty = { HISTORY_EMPTY_SLOT, 0, HISTORY_UNKNOWN_HUMIDITY, 0 };
+        while (head.load(std::memory_order_relaxed) % BLOCK_RECORDS != 0) {
+            writeSlot(empty, timestamp);
+        }
+    }
+    writeSlot(record, timestamp);
+}
+
+void HistoryLog::writeSlot(const PackedHistoryRecord& record, uint32_t timestamp) {
+    uint32_t index = head.load(std::memory_order_relaxed);
+    uint32_t slot = index % getCapacity();
+
+    // Annonce l'écriture avant de toucher à l'emplacement (voir read())
+    writing.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (index % BLOCK_RECORDS == 0) {
+        currentBlockStart = timestamp;
+        blockStart[slot / BLOCK_RECORDS] = timestamp;
+    }
+    PackedHistoryRecord stored = record;
+    if (stored.offsetSeconds != HISTORY_EMPTY_SLOT) {
+        stored.offsetSeconds = (uint16_t)(timestamp - currentBlockStart);
+    }
+    records[slot] = stored;
+
+    head.store(index + 1, std::memory_order_release);
+}
+
+uint32_t HistoryLog::oldestFor(uint32_t count) {
+    // Le bloc en cours d'écriture a perdu son horodatage d'origine : ses
+    // anciens enregistrements ne sont plus lisibles.
+    uint32_t capacity = getCapacity();
+    uint32_t blockEnd = (count + BLOCK_RECORDS - 1) / BLOCK_RECORDS * BLOCK_RECORDS;
+    return blockEnd > capacity ? blockEnd - capacity : 0;
+}
+
+uint32_t HistoryLog::getOldest() {
+    return oldestFor(writing.load(std::memory_order_acquire));
+}
+
+bool HistoryLog::read(uint32_t index, HistoryEntry& entry) {
+    if (!records) return false;
+
+    uint32_t published = head.load(std::memory_order_acquire);
+    if (index >= published || index < oldestFor(published)) return false;
+
+    uint32_t slot = index % getCapacity();
+    PackedHistoryRecord record = records[slot];
+    uint32_t start = blockStart[slot / BLOCK_RECORDS];
+
+    // Rejette la copie si l'écrivain a entamé entre-temps l'écrasement de ce bloc
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (index < oldestFor(writing.load(std::memory_order_relaxed))) return false;
+    if (record.offsetSeconds == HISTORY_EMPTY_SLOT) return false;
+
+    entry.timestamp = start + record.offsetSeconds;
+    entry.temperature = record.temperature;
+    entry.humidity = record.humidity == HISTORY_UNKNOWN_HUMIDITY ? NAN : (float)record.humidity;
+    entry.heaterDuty = record.heaterDuty;
+    return true;
+}
+
+uint32_t HistoryLog::findFirst(uint32_t timestamp) {
+    uint32_t oldest = getOldest();
+    uint32_t lo = oldest / BLOCK_RECORDS;
+    uint32_t hi = (getHead() + BLOCK_RECORDS - 1) / BLOCK_RECORDS;
+
+    // Dernier bloc commencé avant 'timestamp'. Le premier emplacement d'un
+    // bloc n'est jamais vide ; s'il est illisible, il vient d'être écrasé.
+    HistoryEntry entry;
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (!read(mid * BLOCK_RECORDS, entry) || entry.timestamp <= timestamp) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return max(lo * BLOCK_RECORDS, oldest);
+}
@@ -0,0 +1,101 @@
+#ifndef HISTORY_LOG_H
+#define HISTORY_LOG_H
+
+#include "../config/SystemConfig.h"
+#include <atomic>
+
+// Enregistrement compact de l'historique (6 octets, sans remplissage).
+// L'horodatage est un décalage en secondes depuis l'horodatage absolu du
+// bloc auquel appartient l'enregistrement.
+struct PackedHistoryRecord {
+    uint16_t offsetSeconds;   // Depuis le début du bloc (HISTORY_EMPTY_SLOT = emplacement vide)
+    int16_t temperature;      // En int16_t (ex: 255 pour 25.5°C)
+    uint8_t humidity;         // % arrondi (HISTORY_UNKNOWN_HUMIDITY = inconnue)
+    uint8_t heaterDuty;       // Sortie chauffage 0-255
+};
+
+const uint16_t HISTORY_EMPTY_SLOT = 0xFFFF;
+const uint8_t HISTORY_UNKNOWN_HUMIDITY = 0xFF;
+
+// Enregistrement décodé, tel que le voient les lecteurs.
+struct HistoryEntry {
+    uint32_t timestamp;       // Heure Unix
+    int16_t temperature;      // En int16_t
+    float humidity;           // NAN si inconnue
+    uint8_t heaterDuty;
+};
+
+// La classe HistoryLog conserve l'historique minute par minute dans un
+// anneau d'enregistrements compacts alloué en PSRAM (32 jours), ou en SRAM
+// (24 h) si la PSRAM est absente.
+//
+// L'anneau est découpé en blocs de BLOCK_RECORDS enregistrements, chacun
+// avec son horodatage absolu. Un saut d'horloge (synchronisation NTP) ou un
+// décalage trop grand ferme le bloc courant et en ouvre un nouveau.
+//
+// Un seul écrivain (la tâche de régulation) ; les lecteurs (serveur web) ne
+// prennent aucun verrou : read() détecte un enregistrement écrasé pendant
+// la copie et le rejette. Les enregistrements sont repérés par un index
+// absolu croissant (0 = premier enregistrement depuis le démarrage).
+class HistoryLog {
+public:
+    /**
+     * @brief Alloue l'anneau (PSRAM si disponible).
+     * @return true si l'allocation a réussi, false sinon.
+     */
+    static bool initialize();
+
+    /**
+     * @brief Ajoute un enregistrement. Réservé à la tâche de régulation.
+     * Ignoré tant que l'heure n'est pas synchronisée (MIN_VALID_TIMESTAMP).
+     * @param timestamp L'heure Unix de la mesure.
+     * @param temperature La température en int16_t.
+     * @param humidity L'humidité en % (NAN si inconnue).
+     * @param heaterDuty La sortie chauffage (0-255).
+     */
+    static void append(uint32_t timestamp, int16_t temperature, float humidity, uint8_t heaterDuty);
+
+    /**
+     * @brief Index absolu qui suit l'enregistrement le plus récent.
+     */
+    static uint32_t getHead() { return head.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Plus petit index absolu encore conservé dans l'anneau.
+     */
+    static uint32_t getOldest();
+
+    /**
+     * @brief Copie et décode un enregistrement.
+     * @param index L'index absolu de l'enregistrement.
+     * @param entry L'enregistrement décodé.
+     * @return false si l'index est hors de l'anneau, vide ou écrasé pendant la lecture.
+     */
+    static bool read(uint32_t index, HistoryEntry& entry);
+
+    /**
+     * @brief Recherche par dichotomie sur les horodatages des blocs.
+     * @param timestamp L'heure Unix recherchée.
+     * @return L'index du premier enregistrement du bloc qui peut contenir
+     *         'timestamp' (les enregistrements antérieurs restent à filtrer).
+     */
+    static uint32_t findFirst(uint32_t timestamp);
+
+    /**
+     * @brief Nombre d'enregistrements que l'anneau peut contenir.
+     */
+    static uint32_t getCapacity() { return blockCount * HistoryConstants::BLOCK_RECORDS; }
+
+private:
+    static PackedHistoryRecord* records;
+    static uint32_t* blockStart;           // Horodatage absolu de chaque bloc
+    static uint32_t blockCount;
+    static std::atomic<uint32_t> head;     // Enregistrements publiés
+    static std::atomic<uint32_t> writing;  // Enregistrements publiés ou en cours d'écriture
+    static uint32_t currentBlockStart;
+
+    static uint32_t oldestFor(uint32_t count);
+    static void writeSlot(const PackedHistoryRecord& record, uint32_t timestamp);
+};
+
+#endif // HISTORY_LOG_H
@@ -0,0 +1,139 @@
+#include "HistoryRollup.h"
+#include "../utils/Logger.h"
+#include <time.h>
+
+using namespace HistoryConstants;
+
+// Variables statiques
+HistoryRollup::Ring HistoryRollup::rings[2];
+
+bool HistoryRollup::allocate(Ring& ring, uint32_t capacity) {
+    ring.buckets = (RollupBucket*)ps_malloc(capacity * sizeof(RollupBucket));
+    if (!ring.buckets) {
+        capacity = capacity / 8;
+        ring.buckets = (RollupBucket*)malloc(capacity * sizeof(RollupBucket));
+        if (!ring.buckets) return false;
+        LOG_WARN("HISTORY", "PSRAM indisponible : agrégats limités à %lu périodes", (unsigned long)capacity);
+    }
+    ring.capacity = capacity;
+    return true;
+}
+
+bool HistoryRollup::initialize() {
+    if (rings[ROLLUP_HOUR].buckets) return true;
+    if (!allocate(rings[ROLLUP_HOUR], ROLLUP_HOURS) || !allocate(rings[ROLLUP_DAY], ROLLUP_DAYS)) {
+        LOG_ERROR("HISTORY", "Échec allocation des agrégats");
+        return false;
+    }
+    LOG_INFO("HISTORY", "Agrégats : %lu heures, %lu jours",
+             (unsigned long)rings[ROLLUP_HOUR].capacity, (unsigned long)rings[ROLLUP_DAY].capacity);
+    return true;
+}
+
+uint32_t HistoryRollup::periodStart(RollupResolution resolution, uint32_t timestamp) {
+    time_t t = (time_t)timestamp;
+    struct tm local;
+    localtime_r(&t, &local);
+    uint32_t intoHour = local.tm_min * 60 + local.tm_sec;
+    if (resolution == ROLLUP_HOUR) return timestamp - intoHour;
+    return timestamp - local.tm_hour * 3600 - intoHour;
+}
+
+void HistoryRollup::addSample(uint32_t timestamp, int16_t temperature, float humidity, uint8_t heaterDuty,
+                              uint32_t durationSeconds) {
+    if (timestamp < MIN_VALID_TIMESTAMP) return;
+    uint32_t heaterOnSeconds = (uint32_t)heaterDuty * durationSeconds / 255;
+    for (int r = ROLLUP_HOUR; r <= ROLLUP_DAY; r++) {
+        Ring& ring = rings[r];
+        if (!ring.buckets) continue;
+        uint32_t start = periodStart((RollupResolution)r, timestamp);
+        if (start <= ring.restoredThrough) continue;   // Déjà comptée dans la période restaurée
+        accumulate(ring, start, temperature, humidity, heaterOnSeconds);
+    }
+}
+
+void HistoryRollup::restore(RollupResolution resolution, const RollupBucket* buckets, uint32_t count) {
+    Ring& ring = rings[resolution];
+    if (!ring.buckets) return;
+    for (uint32_t i = 0; i < count; i++) {
+        if (buckets[i].samples == 0 || buckets[i].start <= ring.restoredThrough) continue;
+        ring.open = buckets[i];
+        close(ring);
+        ring.restoredThrough = buckets[i].start;
+    }
+}
+
+void HistoryRollup::accumulate(Ring& ring, uint32_t start, int16_t temperature, float humidity,
+                               uint32_t heaterOnSeconds) {
+    // Nouvelle période (ou horloge recalée) : la période en cours est close
+    if (ring.open.samples > 0 && ring.open.start != start) {
+        close(ring);
+    }
+    RollupBucket& b = ring.open;
+    if (b.samples == 0) {
+        b = RollupBucket();
+        b.start = start;
+    }
+    b.samples++;
+    b.tempSum += temperature;
+    if (temperature < b.tempMin) b.tempMin = temperature;
+    if (temperature > b.tempMax) b.tempMax = temperature;
+    if (!isnan(humidity)) {
+        uint8_t hum = (uint8_t)constrain(lroundf(humidity), 0L, 100L);
+        b.humSamples++;
+        b.humSum += hum;
+        if (hum < b.humMin) b.humMin = hum;
+        if (hum > b.humMax) b.humMax = hum;
+    }
+    b.heaterOnSeconds += heaterOnSeconds;
+
+    OpenPeriod period;
+    period.index = ring.closed.load(std::memory_order_relaxed);
+    period.bucket = b;
+    ring.current.write(period);
+}
+
+void HistoryRollup::close(Ring& ring) {
+    uint32_t index = ring.closed.load(std::memory_order_relaxed);
+    ring.writing.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    ring.buckets[index % ring.capacity] = ring.open;
+    ring.closed.store(index + 1, std::memory_order_release);
+    ring.open.samples = 0;
+}
+
+uint32_t HistoryRollup::getHead(RollupResolution resolution) {
+    Ring& ring = rings[resolution];
+    OpenPeriod period = ring.current.read();
+    return period.bucket.samples > 0 ? period.index + 1 : ring.closed.load(std::memory_order_acquire);
+}
+
+uint32_t HistoryRollup::getOldest(RollupResolution resolution) {
+    Ring& ring = rings[resolution];
+    uint32_t count = ring.writing.load(std::memory_order_acquire);
+    return count > ring.capacity ? count - ring.capacity : 0;
+}
+
+bool HistoryRollup::read(RollupResolution resolution, uint32_t index, RollupBucket& bucket) {
+    Ring& ring = rings[resolution];
+    if (!ring.buckets) return false;
+
+    // Période en cours (elle peut avoir été close depuis : même contenu)
+    OpenPeriod period = ring.current.read();
+    if (period.index == index && period.bucket.samples > 0) {
+        bucket = period.bucket;
+        return true;
+    }
+    uint32_t closed = ring.closed.load(std::memory_order_acquire);
+    if (index >= closed) return false;
+    if (closed > ring.capacity && index < closed - ring.capacity) return false;
+
+    bucket = ring.buckets[index % ring.capacity];
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t writing = ring.writing.load(std::memory_order_relaxed);
+    return writing <= ring.capacity || index >= writing - ring.capacity;
+}
+
+RollupBucket HistoryRollup::getCurrent(RollupResolution resolution) {
+    return rings[resolution].current.read().bucket;
+}
@@ -0,0 +1,123 @@
+#ifndef HISTORY_ROLLUP_H
+#define HISTORY_ROLLUP_H
+
+#include "../config/SystemConfig.h"
+#include "../utils/SeqLock.h"
+#include <atomic>
+
+// Agrégat d'une période (heure ou jour local) de l'historique.
+struct RollupBucket {
+    uint32_t start = 0;             // Heure Unix du début de la période
+    uint16_t samples = 0;           // Enregistrements agrégés
+    int16_t tempMin = 32767;        // En int16_t (ex: 255 pour 25.5°C)
+    int16_t tempMax = -32768;
+    int32_t tempSum = 0;
+    uint16_t humSamples = 0;        // Enregistrements avec humidité connue
+    uint8_t humMin = 255;
+    uint8_t humMax = 0;
+    uint32_t humSum = 0;
+    uint32_t heaterOnSeconds = 0;   // Équivalent pleine puissance (sortie / 255 x durée)
+
+    int16_t tempMean() const { return samples ? (int16_t)lroundf((float)tempSum / samples) : 0; }
+    float humMean() const { return humSamples ? (float)humSum / humSamples : NAN; }
+};
+
+enum RollupResolution {
+    ROLLUP_HOUR = 0,
+    ROLLUP_DAY = 1
+};
+
+// La classe HistoryRollup tient à jour, en O(1) par enregistrement, des
+// agrégats horaires (32 jours) et journaliers (400 jours) min/moyenne/max de
+// la température et de l'humidité et du temps de chauffe. Les graphiques
+// longue durée lisent ces agrégats au lieu de parcourir l'historique minute.
+//
+// Même protocole que HistoryLog : un seul écrivain (la tâche de régulation),
+// lecteurs sans verrou. Les périodes closes sont figées jusqu'à leur
+// écrasement ; la période en cours est publiée par SeqLock.
+// Les enregistrements antérieurs à la synchronisation NTP sont ignorés.
+//
+// L'historique minute ne couvre que 32 jours : HistoryStore sauvegarde les
+// jours clos et les rend par restore() au démarrage, avant la relecture.
+class HistoryRollup {
+public:
+    /**
+     * @brief Alloue les anneaux d'agrégats (PSRAM si disponible).
+     * @return true si l'allocation a réussi, false sinon.
+     */
+    static bool initialize();
+
+    /**
+     * @brief Agrège un enregistrement dans l'heure et le jour courants.
+     * @param timestamp L'heure Unix de la mesure.
+     * @param temperature La température en int16_t.
+     * @param humidity L'humidité en % (NAN si inconnue).
+     * @param heaterDuty La sortie chauffage (0-255).
+     * @param durationSeconds La durée représentée par l'enregistrement.
+     */
+    static void addSample(uint32_t timestamp, int16_t temperature, float humidity, uint8_t heaterDuty,
+                          uint32_t durationSeconds);
+
+    /**
+     * @brief Reprend des périodes closes sauvegardées, de la plus ancienne à
+     * la plus récente. À appeler avant tout addSample() : les enregistrements
+     * relus ensuite pour ces périodes sont ignorés dans cet anneau.
+     */
+    static void restore(RollupResolution resolution, const RollupBucket* buckets, uint32_t count);
+
+    /**
+     * @brief Index absolu qui suit la dernière période close.
+     */
+    static uint32_t getClosed(RollupResolution resolution) {
+        return rings[resolution].closed.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Index absolu qui suit la période la plus récente (période en cours comprise).
+     */
+    static uint32_t getHead(RollupResolution resolution);
+
+    /**
+     * @brief Plus petit index absolu encore conservé.
+     */
+    static uint32_t getOldest(RollupResolution resolution);
+
+    /**
+     * @brief Copie une période.
+     * @param resolution L'anneau à lire.
+     * @param index L'index absolu de la période.
+     * @param bucket La période copiée.
+     * @return false si l'index est hors de l'anneau ou a été écrasé pendant la lecture.
+     */
+    static bool read(RollupResolution resolution, uint32_t index, RollupBucket& bucket);
+
+    /**
+     * @brief Copie la période en cours (vide avant le premier enregistrement daté).
+     */
+    static RollupBucket getCurrent(RollupResolution resolution);
+
+private:
+    struct OpenPeriod {
+        uint32_t index = 0;                 // Index absolu de la période en cours
+        RollupBucket bucket;
+    };
+
+    struct Ring {
+        RollupBucket* buckets = nullptr;
+        uint32_t capacity = 0;
+        std::atomic<uint32_t> closed{0};    // Périodes closes publiées
+        std::atomic<uint32_t> writing{0};   // Périodes closes publiées ou en cours d'écriture
+        SeqLock<OpenPeriod> current;        // Période en cours (samples == 0 : aucune)
+        RollupBucket open;                  // Copie de travail de l'écrivain
+        uint32_t restoredThrough = 0;       // Début de la dernière période restaurée
+    };
+
+    static Ring rings[2];
+
+    static bool allocate(Ring& ring, uint32_t capacity);
+    static uint32_t periodStart(RollupResolution resolution, uint32_t timestamp);
+    static void accumulate(Ring& ring, uint32_t start, int16_t temperature, float humidity, uint32_t heaterOnSeconds);
+    static void close(Ring& ring);
+};
+
+#endif // HISTORY_ROLLUP_H
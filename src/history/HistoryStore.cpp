@@ -0,0 +1,345 @@
+#include "HistoryStore.h"
+#include "HistoryRollup.h"
+#include "../utils/Logger.h"
+#include <LittleFS.h>
+
+using namespace HistoryConstants;
+
+static const char* HISTORY_DIR = "/history";
+static const char* DAYS_PATH = "/history/days.bin";
+static const char* DAYS_TEMP_PATH = "/history/days.tmp";
+
+// Variables statiques
+uint32_t HistoryStore::firstSegment = 0;
+uint32_t HistoryStore::currentSegment = 0;
+uint32_t HistoryStore::persistedIndex = 0;
+uint32_t HistoryStore::persistedDays = 0;
+std::atomic<bool> HistoryStore::replayDone{false};
+portMUX_TYPE HistoryStore::pendingMux = portMUX_INITIALIZER_UNLOCKED;
+HistoryStore::PendingRecord HistoryStore::pending[HistoryConstants::PENDING_RECORDS];
+uint8_t HistoryStore::pendingCount = 0;
+TaskHandle_t HistoryStore::replayTask = NULL;
+
+bool HistoryStore::begin() {
+    if (!LittleFS.exists(HISTORY_DIR)) {
+        LittleFS.mkdir(HISTORY_DIR);
+    }
+    File dir = LittleFS.open(HISTORY_DIR);
+    if (!dir || !dir.isDirectory()) {
+        LOG_ERROR("HISTORY", "Répertoire %s inaccessible", HISTORY_DIR);
+        finishReplay();
+        return false;
+    }
+
+    // Jours clos d'abord : la relecture des segments ne les recompte pas
+    loadDays();
+
+    // Numéros de segments présents (noms "NNNNNNNN.seg")
+    bool found = false;
+    uint32_t minSegment = UINT32_MAX, maxSegment = 0;
+    for (File file = dir.openNextFile(); file; file = dir.openNextFile()) {
+        const char* name = file.name();
+        const char* slash = strrchr(name, '/');
+        const char* base = slash ? slash + 1 : name;
+        char* end;
+        uint32_t segment = strtoul(base, &end, 10);
+        if (end != base && strcmp(end, ".seg") == 0) {
+            found = true;
+            minSegment = min(minSegment, segment);
+            maxSegment = max(maxSegment, segment);
+        }
+        file.close();
+    }
+    dir.close();
+
+    if (!found) {
+        LOG_INFO("HISTORY", "Aucun historique enregistré");
+        finishReplay();
+        return true;
+    }
+    firstSegment = minSegment;
+    currentSegment = maxSegment;
+    while (currentSegment - firstSegment + 1 > MAX_SEGMENTS) {
+        LittleFS.remove(segmentPath(firstSegment++));
+    }
+
+    // La relecture (jusqu'à MAX_SEGMENTS x SEGMENT_BYTES) ne retarde pas le démarrage
+    xTaskCreatePinnedToCore(replayLoop, "HistReplay", 4096, NULL, 1, &replayTask, 0);
+    if (replayTask == NULL) {
+        replay();
+    }
+    return true;
+}
+
+void HistoryStore::replayLoop(void* arg) {
+    replay();
+    replayTask = NULL;
+    vTaskDelete(NULL);
+}
+
+void HistoryStore::replay() {
+    unsigned long start = millis();
+    uint32_t records = 0;
+    bool clean = true;
+    for (uint32_t segment = firstSegment; segment <= currentSegment; segment++) {
+        clean = replaySegment(segment, records);
+    }
+
+    // Dernier segment intact et non plein : l'écriture s'y poursuit
+    File last = LittleFS.open(segmentPath(currentSegment), "r");
+    size_t lastSize = last ? last.size() : 0;
+    if (last) last.close();
+    if (!clean || lastSize >= SEGMENT_BYTES) {
+        rotate();
+    }
+
+    LOG_INFO("HISTORY", "Historique relu : %lu enregistrements, segments %lu à %lu (%lu ms)",
+             (unsigned long)records, (unsigned long)firstSegment, (unsigned long)currentSegment,
+             (unsigned long)(millis() - start));
+    finishReplay();
+}
+
+bool HistoryStore::replaySegment(uint32_t segment, uint32_t& records) {
+    File file = LittleFS.open(segmentPath(segment), "r");
+    if (!file) return true;
+
+    HistoryFrameHeader header;
+    PackedHistoryRecord payload[HISTORY_FRAME_MAX_RECORDS];
+    bool clean = true;
+    while (file.available() > 0) {
+        // Trame tronquée ou corrompue : le reste du segment est ignoré
+        if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+            header.magic != HISTORY_FRAME_MAGIC || header.count == 0 ||
+            header.count > HISTORY_FRAME_MAX_RECORDS) {
+            clean = false;
+            break;
+        }
+        size_t bytes = header.count * sizeof(PackedHistoryRecord);
+        if (file.read((uint8_t*)payload, bytes) != bytes || frameCrc(header, payload) != header.crc) {
+            clean = false;
+            break;
+        }
+        for (uint16_t i = 0; i < header.count; i++) {
+            const PackedHistoryRecord& r = payload[i];
+            apply(header.baseTime + r.offsetSeconds, r.temperature,
+                  r.humidity == HISTORY_UNKNOWN_HUMIDITY ? NAN : (float)r.humidity, r.heaterDuty);
+        }
+        records += header.count;
+    }
+    if (!clean) {
+        LOG_WARN("HISTORY", "Segment %lu : trame invalide à l'octet %lu", (unsigned long)segment,
+                 (unsigned long)file.position());
+    }
+    file.close();
+    return clean;
+}
+
+void HistoryStore::finishReplay() {
+    // Tout ce qui est déjà dans l'anneau provient de la flash
+    persistedIndex = HistoryLog::getHead();
+
+    // Les mesures arrivées pendant la relecture passent après elle. replayDone
+    // n'est levé que file vide, sous le verrou : record() prend alors le relais
+    // et HistoryLog ne voit jamais deux écrivains à la fois.
+    for (;;) {
+        PendingRecord next;
+        portENTER_CRITICAL(&pendingMux);
+        if (pendingCount == 0) {
+            replayDone.store(true, std::memory_order_release);
+            portEXIT_CRITICAL(&pendingMux);
+            break;
+        }
+        next = pending[0];
+        pendingCount--;
+        memmove(pending, pending + 1, pendingCount * sizeof(PendingRecord));
+        portEXIT_CRITICAL(&pendingMux);
+        apply(next.timestamp, next.temperature, next.humidity, next.heaterDuty);
+    }
+}
+
+void HistoryStore::record(uint32_t timestamp, int16_t temperature, float humidity, uint8_t heaterDuty) {
+    if (!replayDone.load(std::memory_order_acquire)) {
+        bool queued = false;
+        portENTER_CRITICAL(&pendingMux);
+        if (!replayDone.load(std::memory_order_relaxed)) {
+            if (pendingCount < PENDING_RECORDS) {
+                pending[pendingCount++] = { timestamp, temperature, humidity, heaterDuty };
+            }
+            queued = true;
+        }
+        portEXIT_CRITICAL(&pendingMux);
+        if (queued) return;
+    }
+    apply(timestamp, temperature, humidity, heaterDuty);
+}
+
+void HistoryStore::apply(uint32_t timestamp, int16_t temperature, float humidity, uint8_t heaterDuty) {
+    HistoryLog::append(timestamp, temperature, humidity, heaterDuty);
+    HistoryRollup::addSample(timestamp, temperature, humidity, heaterDuty, RECORD_INTERVAL_MS / 1000);
+}
+
+void HistoryStore::process() {
+    if (!isReplayDone()) return;
+    if (HistoryLog::getHead() - persistedIndex >= FLUSH_RECORDS) {
+        flush();
+    }
+    if (HistoryRollup::getClosed(ROLLUP_DAY) != persistedDays) {
+        // En cas d'échec, nouvel essai au prochain jour clos
+        persistedDays = HistoryRollup::getClosed(ROLLUP_DAY);
+        saveDays();
+    }
+}
+
+bool HistoryStore::flush() {
+    if (!isReplayDone()) return false;
+    uint32_t head = HistoryLog::getHead();
+    if (persistedIndex >= head) return true;
+
+    // Enregistrements écrasés avant d'avoir pu être écrits (flash indisponible)
+    uint32_t oldest = HistoryLog::getOldest();
+    if (persistedIndex < oldest) {
+        LOG_WARN("HISTORY", "%lu enregistrements perdus avant écriture", (unsigned long)(oldest - persistedIndex));
+        persistedIndex = oldest;
+    }
+
+    File file = LittleFS.open(segmentPath(currentSegment), "a");
+    if (!file) {
+        LOG_ERROR("HISTORY", "Ouverture du segment %lu impossible", (unsigned long)currentSegment);
+        return false;
+    }
+
+    HistoryFrameHeader header;
+    PackedHistoryRecord payload[HISTORY_FRAME_MAX_RECORDS];
+    HistoryEntry entry;
+    bool ok = true;
+    while (persistedIndex < head && ok) {
+        header.magic = HISTORY_FRAME_MAGIC;
+        header.count = 0;
+        header.baseTime = 0;
+        uint32_t index = persistedIndex;
+        for (; index < head && header.count < HISTORY_FRAME_MAX_RECORDS; index++) {
+            if (!HistoryLog::read(index, entry)) continue; // Emplacement vide
+            if (header.count == 0) {
+                header.baseTime = entry.timestamp;
+            } else if (entry.timestamp < header.baseTime || entry.timestamp - header.baseTime >= HISTORY_EMPTY_SLOT) {
+                break; // Saut d'horloge : nouvelle trame
+            }
+            PackedHistoryRecord& r = payload[header.count++];
+            r.offsetSeconds = (uint16_t)(entry.timestamp - header.baseTime);
+            r.temperature = entry.temperature;
+            r.humidity = isnan(entry.humidity) ? HISTORY_UNKNOWN_HUMIDITY : (uint8_t)entry.humidity;
+            r.heaterDuty = entry.heaterDuty;
+        }
+        if (header.count > 0) {
+            header.crc = frameCrc(header, payload);
+            size_t bytes = header.count * sizeof(PackedHistoryRecord);
+            ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                 file.write((const uint8_t*)payload, bytes) == bytes;
+        }
+        if (ok) persistedIndex = index;
+    }
+    size_t size = file.size();
+    file.close();
+
+    if (!ok) {
+        // Ne jamais écrire derrière une trame tronquée
+        LOG_ERROR("HISTORY", "Écriture du segment %lu incomplète", (unsigned long)currentSegment);
+        rotate();
+        return false;
+    }
+    if (size >= SEGMENT_BYTES) {
+        rotate();
+    }
+    return true;
+}
+
+void HistoryStore::rotate() {
+    currentSegment++;
+    while (currentSegment - firstSegment + 1 > MAX_SEGMENTS) {
+        LittleFS.remove(segmentPath(firstSegment++));
+    }
+}
+
+void HistoryStore::loadDays() {
+    File file = LittleFS.open(DAYS_PATH, "r");
+    if (!file) return;
+    HistoryDaysHeader header;
+    RollupBucket* days = nullptr;
+    bool ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              header.magic == HISTORY_DAYS_MAGIC && header.count <= ROLLUP_DAYS;
+    size_t bytes = ok ? header.count * sizeof(RollupBucket) : 0;
+    if (ok && bytes > 0) {
+        days = (RollupBucket*)ps_malloc(bytes);
+        if (!days) days = (RollupBucket*)malloc(bytes);
+        ok = days && file.read((uint8_t*)days, bytes) == bytes;
+    }
+    file.close();
+    if (ok) {
+        uint32_t crc = crc32(0xFFFFFFFF, (const uint8_t*)&header.count, sizeof(header.count));
+        ok = ~crc32(crc, (const uint8_t*)days, bytes) == header.crc;
+    }
+    if (ok) {
+        HistoryRollup::restore(ROLLUP_DAY, days, header.count);
+        persistedDays = HistoryRollup::getClosed(ROLLUP_DAY);
+        LOG_INFO("HISTORY", "%u jours d'agrégats restaurés", header.count);
+    } else {
+        LOG_WARN("HISTORY", "%s invalide, agrégats journaliers ignorés", DAYS_PATH);
+    }
+    free(days);
+}
+
+bool HistoryStore::saveDays() {
+    // Jours clos encore dans l'anneau ; la tâche de régulation peut en
+    // écraser pendant la copie, read() les rejette alors
+    uint32_t closed = HistoryRollup::getClosed(ROLLUP_DAY);
+    uint32_t oldest = HistoryRollup::getOldest(ROLLUP_DAY);
+    uint32_t capacity = min(closed - oldest, ROLLUP_DAYS);
+    RollupBucket* days = capacity ? (RollupBucket*)ps_malloc(capacity * sizeof(RollupBucket)) : nullptr;
+    if (capacity && !days) days = (RollupBucket*)malloc(capacity * sizeof(RollupBucket));
+    if (capacity && !days) return false;
+    HistoryDaysHeader header = { HISTORY_DAYS_MAGIC, 0, 0 };
+    for (uint32_t index = closed - capacity; index < closed; index++) {
+        if (HistoryRollup::read(ROLLUP_DAY, index, days[header.count])) header.count++;
+    }
+    size_t bytes = header.count * sizeof(RollupBucket);
+    uint32_t crc = crc32(0xFFFFFFFF, (const uint8_t*)&header.count, sizeof(header.count));
+    header.crc = ~crc32(crc, (const uint8_t*)days, bytes);
+
+    File file = LittleFS.open(DAYS_TEMP_PATH, "w");
+    bool ok = file &&
+              file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              file.write((const uint8_t*)days, bytes) == bytes;
+    if (file) file.close();
+    free(days);
+    if (!ok || !LittleFS.rename(DAYS_TEMP_PATH, DAYS_PATH)) {
+        LOG_ERROR("HISTORY", "Écriture de %s impossible", DAYS_PATH);
+        LittleFS.remove(DAYS_TEMP_PATH);
+        return false;
+    }
+    return true;
+}
+
+String HistoryStore::segmentPath(uint32_t segment) {
+    char path[32];
+    snprintf(path, sizeof(path), "%s/%08lu.seg", HISTORY_DIR, (unsigned long)segment);
+    return String(path);
+}
+
+uint32_t HistoryStore::frameCrc(const HistoryFrameHeader& header, const PackedHistoryRecord* records) {
+    // CRC-32 de count, baseTime puis des enregistrements
+    uint32_t crc = crc32(0xFFFFFFFF, (const uint8_t*)&header.count, sizeof(header.count));
+    crc = crc32(crc, (const uint8_t*)&header.baseTime, sizeof(header.baseTime));
+    crc = crc32(crc, (const uint8_t*)records, header.count * sizeof(PackedHistoryRecord));
+    return ~crc;
+}
+
+uint32_t HistoryStore::crc32(uint32_t crc, const uint8_t* data, size_t length) {
+    // CRC-32 (IEEE 802.3, réfléchi), sans inversion finale : calcul par morceaux
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+        }
+    }
+    return crc;
+}
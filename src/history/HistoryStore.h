@@ -0,0 +1,113 @@
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+#include "../config/SystemConfig.h"
+#include "HistoryLog.h"
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// En-tête d'une trame du journal d'historique sur LittleFS, suivi de
+// 'count' PackedHistoryRecord dont les décalages partent de baseTime.
+struct HistoryFrameHeader {
+    uint16_t magic;           // HISTORY_FRAME_MAGIC
+    uint16_t count;           // Enregistrements de la trame (1 à HISTORY_FRAME_MAX_RECORDS)
+    uint32_t baseTime;        // Heure Unix de référence des décalages
+    uint32_t crc;             // CRC-32 de count, baseTime et des enregistrements
+};
+
+const uint16_t HISTORY_FRAME_MAGIC = 0x4846;   // "HF"
+const uint16_t HISTORY_FRAME_MAX_RECORDS = 60;
+
+// En-tête de /history/days.bin, suivi de 'count' RollupBucket journaliers
+// clos, du plus ancien au plus récent.
+struct HistoryDaysHeader {
+    uint16_t magic;           // HISTORY_DAYS_MAGIC
+    uint16_t count;
+    uint32_t crc;             // CRC-32 de count et des agrégats
+};
+
+const uint16_t HISTORY_DAYS_MAGIC = 0x4844;    // "HD"
+
+// La classe HistoryStore rend l'historique persistant. Les enregistrements
+// passent par record() (tâche de régulation), qui alimente HistoryLog et
+// HistoryRollup. Toutes les FLUSH_RECORDS minutes, process() (tâche
+// principale) relit l'anneau HistoryLog, qui sert de tampon, et ajoute des
+// trames CRC en fin de segment /history/NNNNNNNN.seg. Les segments tournent
+// à SEGMENT_BYTES ; les plus anciens sont supprimés au-delà de MAX_SEGMENTS.
+//
+// Au démarrage, begin() ne fait que lister les segments : la relecture tourne
+// dans une tâche de faible priorité. Les enregistrements reçus pendant la
+// relecture sont mis en attente puis ajoutés après elle. Une trame tronquée
+// (coupure pendant l'écriture) termine la relecture de son segment, et
+// l'écriture reprend alors dans un nouveau segment.
+//
+// Les segments ne couvrent que ~32 jours : les agrégats journaliers clos
+// (jusqu'à ROLLUP_DAYS) sont réécrits dans /history/days.bin à chaque
+// nouveau jour et rendus à HistoryRollup par begin(), avant la relecture.
+class HistoryStore {
+public:
+    /**
+     * @brief Liste les segments et lance leur relecture (LittleFS doit être monté).
+     * @return true si le répertoire d'historique est accessible, false sinon.
+     */
+    static bool begin();
+
+    /**
+     * @brief Enregistre une mesure (tâche de régulation uniquement).
+     * @param timestamp L'heure Unix de la mesure.
+     * @param temperature La température en int16_t.
+     * @param humidity L'humidité en % (NAN si inconnue).
+     * @param heaterDuty La sortie chauffage (0-255).
+     */
+    static void record(uint32_t timestamp, int16_t temperature, float humidity, uint8_t heaterDuty);
+
+    /**
+     * @brief Écrit en flash les enregistrements en attente s'il y en a assez.
+     * À appeler régulièrement depuis la tâche principale.
+     */
+    static void process();
+
+    /**
+     * @brief Écrit immédiatement tous les enregistrements en attente.
+     * @return true si l'écriture a réussi, false sinon.
+     */
+    static bool flush();
+
+    /**
+     * @brief Indique si la relecture du journal est terminée.
+     */
+    static bool isReplayDone() { return replayDone.load(std::memory_order_acquire); }
+
+private:
+    struct PendingRecord {
+        uint32_t timestamp;
+        int16_t temperature;
+        float humidity;
+        uint8_t heaterDuty;
+    };
+
+    static uint32_t firstSegment;
+    static uint32_t currentSegment;
+    static uint32_t persistedIndex;          // Prochain index HistoryLog à écrire
+    static uint32_t persistedDays;           // Jours clos déjà dans days.bin
+    static std::atomic<bool> replayDone;
+    static portMUX_TYPE pendingMux;
+    static PendingRecord pending[HistoryConstants::PENDING_RECORDS];
+    static uint8_t pendingCount;
+    static TaskHandle_t replayTask;
+
+    static void replayLoop(void* arg);
+    static void replay();
+    static bool replaySegment(uint32_t segment, uint32_t& records);
+    static void finishReplay();
+    static void apply(uint32_t timestamp, int16_t temperature, float humidity, uint8_t heaterDuty);
+    static void rotate();
+    static void loadDays();
+    static bool saveDays();
+    static String segmentPath(uint32_t segment);
+    static uint32_t frameCrc(const HistoryFrameHeader& header, const PackedHistoryRecord* records);
+    static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t length);
+};
+
+#endif // HISTORY_STORE_H
@@ -6,15 +6,22 @@
 #include "config/ConfigManager.h"
 #include "sensors/SensorManager.h"
 #include "sensors/SafetySystem.h"
+#include "control/HeaterLoop.h"
+#include "control/ControlTask.h"
+#include "control/SystemSnapshot.h"
+#include "history/HistoryLog.h"
+#include "history/HistoryRollup.h"
+#include "history/HistoryStore.h"
 #include "utils/Logger.h"
 #include "web/AppWebServer.h"
 #include "wifi_credentials.h"
 #include "hardware/CameraManager.h" // Ajout de l'en-tête
+#include "hardware/MotionRecorder.h"
+#include "hardware/Timelapse.h"
 
 // === INCLUDES MATÉRIELS ===
 #include <WiFi.h>
 #include <time.h>
-#include <PID_v1.h>
 #include <Wire.h>
 #include <Adafruit_SSD1306.h>
 #include <Adafruit_NeoPixel.h>
@@ -29,34 +36,18 @@
 
 // === CONFIGURATION MATÉRIELLE ===
 using namespace HardwareConstants;
+using namespace ControlConstants;
+using namespace TimeConstants;
 
 // === VARIABLES GLOBALES ===
 SystemConfig config;
 
-// Variables de mesure
-int16_t internalTemp = 0;
-float internalHum = NAN;
+// Variables de mesure (les mesures internes sont lues via SensorManager::getLatestSample)
 float externalTemp = 0.0f;
 float externalHum = 0.0f;
 
-// Contrôle chauffage
-bool heaterState = false;
-double input, output = 0;
-unsigned long lastToggleTime = 0;
-bool manualCycleOn = false;
-
-// Historique
-HistoryRecord history[MAX_HISTORY_RECORDS];
-int historyIndex = 0;
-bool historyFull = false;
-
-// Statistiques (simplifiées)
-int16_t maxTemperature = -32768;
-int16_t minTemperature = 32767;
-
 // Objets matériels
 AsyncWebServer server(80);
-PID myPID(&input, &output, (double*)&config.setpoint, config.Kp, config.Ki, config.Kd, DIRECT);
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
 Adafruit_NeoPixel pixels(NUMPIXELS, APP_PIN_NEOPIXEL, NEO_GRB + NEO_KHZ800);
 
@@ -71,6 +62,9 @@ const int pageCount = 4;
 
 // === DÉCLARATIONS DE FONCTIONS ===
 void mainApplicationTask(void *pvParameters);
+void controlCycle();
+void publishCycleSnapshot(const SensorSample& sample);
+void initTimeZone();
 void initFileSystem();
 void initHardware();
 void initNetworking();
@@ -78,9 +72,7 @@ void initSensors();
 void initWebServer();
 void initTasks();
 
-int16_t getCurrentTargetTemperature();
-void controlHeater(int16_t currentTemperature);
-void addToHistory(int16_t temperature, float humidity);
+void addToHistory(int16_t temperature, float humidity, uint8_t heaterDuty);
 void renderOLEDPage(int page);
 bool updateDisplaySafe();
 
@@ -94,6 +86,7 @@ void setup() {
     LOG_INFO("MAIN", "🚀 CONTRÔLEUR VIVARIUM v2.0 REFACTORISÉ");
     LOG_INFO("MAIN", "==================================================");
     
+    initTimeZone();
     initFileSystem();
     LOG_INFO("MAIN", "Current profile name: %s", config.currentProfileName.c_str());
     initHardware();
@@ -115,12 +108,23 @@ void loop() {
 // FONCTIONS D'INITIALISATION MODULAIRES
 // ========================================
 
+void initTimeZone() {
+    // HistoryStore::begin() relit l'historique en tâche de fond pendant
+    // l'attente du WiFi : localtime_r doit déjà découper les jours en heure
+    // locale, sinon les cumuls journaliers relus sont calés sur UTC
+    setenv("TZ", TIME_ZONE, 1);
+    tzset();
+}
+
 void initFileSystem() {
     LOG_INFO("FILESYSTEM", "Initialisation...");
     if (!ConfigManager::initialize()) {
         LOG_ERROR("FILESYSTEM", "Échec initialisation ConfigManager");
         return;
     }
+    if (!HistoryLog::initialize() || !HistoryRollup::initialize() || !HistoryStore::begin()) {
+        LOG_ERROR("FILESYSTEM", "Échec initialisation historique");
+    }
     if (!ConfigManager::loadConfig(config)) {
         LOG_ERROR("FILESYSTEM", "Échec chargement configuration");
         return;
@@ -147,11 +151,10 @@ void initHardware() {
         pixels.setPixelColor(0, pixels.Color(0, 0, 0));
     }
     pixels.show();
-    myPID.SetMode(AUTOMATIC);
-    myPID.SetOutputLimits(0, 255);
-    myPID.SetTunings(config.Kp, config.Ki, config.Kd);
-    if (config.cameraEnabled) {
-        CameraManager::initialize(config);
+    initHeaterLoop();
+    if (config.cameraEnabled && CameraManager::initialize(config)) {
+        MotionRecorder::begin();
+        Timelapse::begin();
     }
     LOG_INFO("HARDWARE", "Initialisation réussie.");
 }
@@ -171,7 +174,8 @@ void initNetworking() {
     } else {
         LOG_ERROR("NETWORK", "Échec de la connexion WiFi.");
     }
-    configTime(3600, 0, "pool.ntp.org", "time.nist.gov");
+    // Même fuseau que initTimeZone() : les jours déjà cumulés ne bougent pas
+    configTzTime(TIME_ZONE, NTP_SERVER_1, NTP_SERVER_2);
     struct tm timeinfo;
     if (getLocalTime(&timeinfo)) {
         LOG_INFO("NETWORK", "Heure synchronisée (NTP).");
@@ -183,6 +187,7 @@ void initNetworking() {
 void initSensors() {
     LOG_INFO("SENSORS", "Initialisation...");
     SensorManager::setI2CMutex(i2cMutex);
+    SafetySystem::setI2CMutex(i2cMutex);
     if (!SensorManager::initialize()) {
         LOG_ERROR("SENSORS", "Échec initialisation SensorManager");
         return;
@@ -200,6 +205,8 @@ void initSensors() {
     display.println("Initialisation...");
     display.display();
     SafetySystem::initialize();
+    // Première mesure synchrone : la régulation démarre avec une valeur publiée
+    SensorManager::updateSensors();
     LOG_INFO("SENSORS", "Initialisation réussie.");
 }
 
@@ -226,6 +233,14 @@ void initTasks() {
         LOG_ERROR("TASKS", "Échec création tâche principale");
         return;
     }
+    if (!SensorManager::startTask(SENSOR_PERIOD_MS)) {
+        LOG_ERROR("TASKS", "Échec démarrage tâche capteur");
+        return;
+    }
+    if (!ControlTask::start(controlCycle, CONTROL_PERIOD_MS)) {
+        LOG_ERROR("TASKS", "Échec démarrage boucle de régulation");
+        return;
+    }
     LOG_INFO("TASKS", "Tâches créées avec succès.");
 }
 
@@ -236,36 +251,26 @@ void initTasks() {
 void mainApplicationTask(void *pvParameters) {
     LOG_INFO("TASKS", "Tâche principale démarrée sur Core 1");
     esp_task_wdt_add(NULL);
-    unsigned long lastSensorUpdate = 0;
     unsigned long lastDisplayUpdate = 0;
     unsigned long lastPageChange = 0;
-    unsigned long lastHistoryUpdate = 0;
     
+    // La mesure et la régulation tournent dans ControlTask (controlCycle) ;
+    // cette tâche ne garde que les travaux lents : flash, affichage et envoi
+    // des événements web (un nouvel instantané est poussé en moins de 100 ms).
     for (;;) {
         esp_task_wdt_reset();
         unsigned long now = millis();
         
-        if (now - lastSensorUpdate >= 2000) {
-            lastSensorUpdate = now;
-            if (SensorManager::updateSensors()) {
-                internalTemp = SensorManager::getCurrentTemperature();
-                internalHum = SensorManager::getCurrentHumidity();
-                if (internalTemp > maxTemperature) maxTemperature = internalTemp;
-                if (internalTemp < minTemperature) minTemperature = internalTemp;
-                controlHeater(internalTemp);
-                if (now - lastHistoryUpdate >= 60000) {
-                    lastHistoryUpdate = now;
-                    addToHistory(internalTemp, internalHum);
-                }
-            }
-            SafetySystem::checkConditions(internalTemp, internalHum);
-        }
-        
         ConfigManager::processPendingSave(config);
+        HistoryStore::process();
+        Timelapse::process(config);
+        AppWebServerManager::pushStatusEvents();
         
+        // Écran de sécurité posté par la régulation : affiché sous 100 ms
+        SafetySystem::renderDisplay();
         if (now - lastDisplayUpdate >= 1000) {
             lastDisplayUpdate = now;
-            if (SafetySystem::getCurrentLevel() == SAFETY_NORMAL) {
+            if (!SafetySystem::ownsDisplay()) {
                 renderOLEDPage(displayPage);
                 updateDisplaySafe();
             }
@@ -273,7 +278,7 @@ void mainApplicationTask(void *pvParameters) {
         
         if (now - lastPageChange >= 10000) {
             lastPageChange = now;
-            if (SafetySystem::getCurrentLevel() == SAFETY_NORMAL) {
+            if (getSystemSnapshot().safetyLevel == SAFETY_NORMAL) {
                 displayPage = (displayPage + 1) % pageCount;
             }
         }
@@ -283,66 +288,59 @@ void mainApplicationTask(void *pvParameters) {
 }
 
 // ========================================
-// FONCTIONS DE CONTRÔLE
+// BOUCLE DE RÉGULATION (ControlTask)
 // ========================================
 
-int16_t getCurrentTargetTemperature() {
-    struct tm timeinfo;
-    if (!getLocalTime(&timeinfo)) {
-        return config.setpoint;
-    }
-    return config.getTempCurve(timeinfo.tm_hour);
-}
-
-void controlHeater(int16_t currentTemperature) {
-    if (SafetySystem::isEmergencyShutdown() || SafetySystem::getCurrentLevel() >= SAFETY_CRITICAL) {
-        output = 0;
-        analogWrite(HEATER_PIN, 0);
-        //LOG_WARN("HEATER", "Chauffage bloqué par le système de sécurité (Niveau: %d)", SafetySystem::getCurrentLevel());
-        return;
-    }
-    
-    int16_t targetTemp = getCurrentTargetTemperature();
-    int16_t maxTemp = targetTemp;
-    int16_t minTemp = targetTemp - (int16_t)(config.hysteresis * 10);
+void controlCycle() {
+    static unsigned long lastHistoryUpdate = 0;
+    static uint32_t lastSequence = 0;
     unsigned long now = millis();
     
-    if (currentTemperature >= maxTemp) {
-        output = 0;
-        manualCycleOn = false;
-    } else if (currentTemperature < minTemp) {
-        output = 255;
-        manualCycleOn = false;
-    } else {
-        if (config.usePWM) {
-            input = (double)currentTemperature / 10.0;
-            myPID.SetTunings(config.Kp, config.Ki, config.Kd);
-            myPID.Compute();
-            output = constrain(output, 0, 255);
-        } else {
-            if (manualCycleOn && now - lastToggleTime >= 990) {
-                manualCycleOn = false;
-                lastToggleTime = now;
-            } else if (!manualCycleOn && now - lastToggleTime >= 2990) {
-                manualCycleOn = true;
-                lastToggleTime = now;
-            }
-            output = manualCycleOn ? 255 : 0;
+    // Aucun accès I2C ici : la tâche capteur publie les mesures
+    SensorSample sample = SensorManager::getLatestSample();
+    if (sample.sequence != lastSequence) {
+        lastSequence = sample.sequence;
+        controlHeater(sample.temperature);
+        if (now - lastHistoryUpdate >= HistoryConstants::RECORD_INTERVAL_MS) {
+            lastHistoryUpdate = now;
+            addToHistory(sample.temperature, sample.humidity, (uint8_t)getHeaterOutput());
         }
     }
-    
-    if (SafetySystem::getCurrentLevel() == SAFETY_WARNING) {
-        output = min(output, 128.0);
-    }
-    
-    analogWrite(HEATER_PIN, output);
+    SafetySystem::checkConditions(sample.temperature, sample.humidity);
+    publishCycleSnapshot(sample);
+}
+
+void publishCycleSnapshot(const SensorSample& sample) {
+    SystemSnapshot snapshot;
+    snapshot.timestampMs = millis();
+    snapshot.temperature = sample.temperature;
+    snapshot.humidity = sample.humidity;
+    snapshot.sensorValid = sample.valid;
+    snapshot.sensorSequence = sample.sequence;
+    snapshot.sensorTimestampMs = sample.timestampMs;
+    // Extrêmes du jour (agrégat journalier), la mesure courante comprise
+    RollupBucket today = HistoryRollup::getCurrent(ROLLUP_DAY);
+    snapshot.maxTemperature = today.samples ? max(today.tempMax, sample.temperature) : sample.temperature;
+    snapshot.minTemperature = today.samples ? min(today.tempMin, sample.temperature) : sample.temperature;
+    snapshot.targetTemperature = getCurrentTargetTemperature();
+    snapshot.heaterOutput = (float)getHeaterOutput();
+    snapshot.usePWM = config.usePWM;
+    snapshot.Kp = config.Kp;
+    snapshot.Ki = config.Ki;
+    snapshot.Kd = config.Kd;
+    snapshot.hysteresis = config.hysteresis;
+    snapshot.safetyLevel = SafetySystem::getCurrentLevel();
+    snapshot.emergencyShutdown = SafetySystem::isEmergencyShutdown();
+    strlcpy(snapshot.safetyMessage, SafetySystem::getLastErrorMessage().c_str(), sizeof(snapshot.safetyMessage));
+    publishSystemSnapshot(snapshot);
 }
 
-void addToHistory(int16_t temperature, float humidity) {
-    time_t now = time(nullptr);
-    history[historyIndex] = { now, (float)temperature, humidity };
-    historyIndex = (historyIndex + 1) % MAX_HISTORY_RECORDS;
-    if (historyIndex == 0) historyFull = true;
+// ========================================
+// HISTORIQUE ET AFFICHAGE
+// ========================================
+
+void addToHistory(int16_t temperature, float humidity, uint8_t heaterDuty) {
+    HistoryStore::record((uint32_t)time(nullptr), temperature, humidity, heaterDuty);
     LOG_DEBUG("HISTORY", "Historique mis à jour: %.1f°C, %.0f%%", (float)temperature / 10.0f, humidity);
 }
 
@@ -355,21 +353,24 @@ void renderOLEDPage(int page) {
     struct tm timeinfo;
     getLocalTime(&timeinfo);
     
+    // Valeurs du dernier cycle de régulation, cohérentes entre elles
+    SystemSnapshot snapshot = getSystemSnapshot();
+    
     switch (page) {
         case 0:
-            display.printf("Temp: %.1fC (%.1f)\n", (float)internalTemp / 10.0f, (float)getCurrentTargetTemperature() / 10.0f);
-            display.printf("Hum:  %.0f%%\n", internalHum);
-            display.printf("Chauf: %s (%.0f)\n", output > 0 ? "ON" : "OFF", output);
-            display.printf("Mode: %s\n", config.usePWM ? "PWM" : "ON/OFF");
+            display.printf("Temp: %.1fC (%.1f)\n", (float)snapshot.temperature / 10.0f, (float)snapshot.targetTemperature / 10.0f);
+            display.printf("Hum:  %.0f%%\n", snapshot.humidity);
+            display.printf("Chauf: %s (%.0f)\n", snapshot.heaterOutput > 0 ? "ON" : "OFF", snapshot.heaterOutput);
+            display.printf("Mode: %s\n", snapshot.usePWM ? "PWM" : "ON/OFF");
             display.printf("Prof: %s", config.currentProfileName.c_str());
             break;
         case 1:
             display.println("STATISTIQUES");
             display.drawLine(0, 10, display.width(), 10, SSD1306_WHITE);
-            display.printf("T Max: %.1fC\n", (float)maxTemperature / 10.0f);
-            display.printf("T Min: %.1fC\n", (float)minTemperature / 10.0f);
-            display.printf("Capteur: %s\n", SensorManager::isDataValid() ? "OK" : "ERR");
-            display.printf("Securite: %d", SafetySystem::getCurrentLevel());
+            display.printf("T Max: %.1fC\n", (float)snapshot.maxTemperature / 10.0f);
+            display.printf("T Min: %.1fC\n", (float)snapshot.minTemperature / 10.0f);
+            display.printf("Capteur: %s\n", snapshot.sensorValid ? "OK" : "ERR");
+            display.printf("Securite: %d", snapshot.safetyLevel);
             break;
         case 2:
             display.println("SYSTEME");
@@ -383,7 +384,7 @@ void renderOLEDPage(int page) {
         case 3:
             display.println("MODES");
             display.drawLine(0, 10, display.width(), 10, SSD1306_WHITE);
-            display.printf("PWM: %s\n", config.usePWM ? "ON" : "OFF");
+            display.printf("PWM: %s\n", snapshot.usePWM ? "ON" : "OFF");
             display.printf("Meteo: %s\n", config.weatherModeEnabled ? "ON" : "OFF");
             display.printf("Camera: %s", config.cameraEnabled ? "ON" : "OFF");
             break;
@@ -407,18 +408,3 @@ SystemConfig& getGlobalConfig() {
     return config;
 }
 
-double getHeaterOutput() {
-    return output;
-}
-
-HistoryRecord* getHistory() {
-    return history;
-}
-
-int getHistoryIndex() {
-    return historyIndex;
-}
-
-bool isHistoryFull() {
-    return historyFull;
-}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef NATIVE_HARNESS_H
+#define NATIVE_HARNESS_H
+
+// Programmes de l'environnement [env:native] (voir main_native.cpp).
+
+#include "../sensors/SensorManager.h"
+
+/**
+ * @brief Remet les substituts à zéro et initialise configuration, capteurs,
+ *        sécurité et chauffage comme setup() sur la cible.
+ * @return true si l'initialisation a réussi, false sinon.
+ */
+bool initNativeSystem();
+
+/**
+ * @brief Décode la valeur d'une option --sensor=library|single|periodic.
+ * @return true si la valeur est reconnue, false sinon.
+ */
+bool parseSensorMode(const char* value, SensorAcquisitionMode& mode);
+
+/**
+ * @brief Mesure le débit de la chaîne capteur -> sécurité -> chauffage.
+ */
+int runControlBenchmark(int argc, char** argv);
+
+/**
+ * @brief Simule le vivarium en boucle fermée et affiche les indicateurs de régulation.
+ */
+int runPlantSimulation(int argc, char** argv);
+
+#endif // NATIVE_HARNESS_H
@@ -0,0 +1,230 @@
+// Simulation en boucle fermée du tapis chauffant sur l'horloge virtuelle.
+//
+//   program sim [--days=7] [--pwm=0|1] [--controller=loop|class]
+//               [--kp=..] [--ki=..] [--kd=..] [--hysteresis=..]
+//               [--power=25] [--ambient=20] [--warmup=6] [--seed=1]
+//               [--sensor=library|single|periodic]
+//
+// Le modèle ThermalPlant alimente le capteur simulé ; la régulation réelle
+// (controlHeater() de la tâche principale, ou HeaterControl::updateControl())
+// commande HEATER_PIN à chaque CONTROL_PERIOD_MS, comme ControlTask sur la cible.
+// Les indicateurs portent sur la température réelle de l'enceinte, hors
+// période de mise en chauffe (--warmup heures).
+
+#include <Arduino.h>
+#include <cmath>
+#include <string>
+#include "NativeHarness.h"
+#include "ThermalPlant.h"
+#include "../config/SystemConfig.h"
+#include "../sensors/SensorManager.h"
+#include "../sensors/SafetySystem.h"
+#include "../hardware/HeaterControl.h"
+#include "../control/HeaterLoop.h"
+
+using namespace HardwareConstants;
+
+extern SystemConfig config;
+
+namespace {
+
+const unsigned long PLANT_STEP_MS = 1000;
+const double SETTLING_BAND_C = 0.5;
+
+struct SimOptions {
+    double days = 7.0;
+    double warmupHours = 6.0;
+    bool usePWM = false;
+    bool useHeaterClass = false;
+    float kp = -1, ki = -1, kd = -1;
+    float hysteresis = -1;
+    SensorAcquisitionMode sensorMode = SENSOR_ACQ_SINGLE_SHOT;
+    ThermalPlantParams plant;
+};
+
+bool parseOption(const std::string& arg, SimOptions& opt) {
+    size_t eq = arg.find('=');
+    if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos) return false;
+    std::string key = arg.substr(2, eq - 2);
+    std::string value = arg.substr(eq + 1);
+    double v = atof(value.c_str());
+
+    if (key == "days") opt.days = v;
+    else if (key == "warmup") opt.warmupHours = v;
+    else if (key == "pwm") opt.usePWM = v != 0;
+    else if (key == "controller") {
+        if (value != "loop" && value != "class") return false;
+        opt.useHeaterClass = value == "class";
+    }
+    else if (key == "kp") opt.kp = v;
+    else if (key == "ki") opt.ki = v;
+    else if (key == "kd") opt.kd = v;
+    else if (key == "hysteresis") opt.hysteresis = v;
+    else if (key == "power") opt.plant.heaterPowerW = v;
+    else if (key == "ambient") opt.plant.ambientMeanC = v;
+    else if (key == "seed") opt.plant.seed = (uint32_t)v;
+    else if (key == "sensor") return parseSensorMode(value.c_str(), opt.sensorMode);
+    else return false;
+    return true;
+}
+
+// Indicateurs de régulation. Chaque changement de consigne ouvre un
+// segment ; dépassement et temps d'établissement sont calculés par segment.
+class ControlMetrics {
+public:
+    void sample(double t, double dt, double temperature, double target, double powerW, int duty) {
+        if (target != segTarget) closeSegment(t, target);
+
+        double error = temperature - target;
+        if (std::fabs(error) > SETTLING_BAND_C) lastOutsideBand = t;
+        if (stepUp) segPeak = std::max(segPeak, error);
+        else segPeak = std::max(segPeak, -error);
+
+        squaredError += error * error * dt;
+        maxAbsError = std::max(maxAbsError, std::fabs(error));
+        energyJ += powerW * dt;
+        dutySum += duty * dt;
+        duration += dt;
+
+        bool on = duty > 0;
+        if (on != heaterOn) switches++;
+        heaterOn = on;
+    }
+
+    void finish(double t) { closeSegment(t, segTarget); }
+
+    void print() const {
+        Serial.printf("Durée analysée      : %.1f h\n", duration / 3600.0);
+        Serial.printf("Erreur RMS          : %.3f °C (max %.2f °C)\n",
+                      duration > 0 ? std::sqrt(squaredError / duration) : 0.0, maxAbsError);
+        Serial.printf("Changements consigne: %d\n", segments);
+        if (segments > 0) {
+            Serial.printf("Dépassement         : moyen %.2f °C, max %.2f °C\n", overshootSum / segments, overshootMax);
+        }
+        int settled = segments - unsettled;
+        if (settled > 0) {
+            Serial.printf("Établissement ±%.1f : moyen %.1f min, pire %.1f min (%d non établis)\n",
+                          SETTLING_BAND_C, settlingSum / settled / 60.0, settlingMax / 60.0, unsettled);
+        } else {
+            Serial.printf("Établissement ±%.1f : aucun segment établi (%d)\n", SETTLING_BAND_C, unsettled);
+        }
+        Serial.printf("Énergie             : %.3f kWh (%.1f Wh/jour)\n",
+                      energyJ / 3.6e6, duration > 0 ? energyJ / 3600.0 / (duration / 86400.0) : 0.0);
+        Serial.printf("Rapport cyclique    : %.1f %%\n", duration > 0 ? dutySum / duration / 2.55 : 0.0);
+        Serial.printf("Commutations        : %lu (%.1f/h)\n", switches, duration > 0 ? switches / (duration / 3600.0) : 0.0);
+    }
+
+private:
+    void closeSegment(double t, double newTarget) {
+        if (segStart >= 0) {
+            segments++;
+            double overshoot = std::max(0.0, segPeak);
+            overshootSum += overshoot;
+            overshootMax = std::max(overshootMax, overshoot);
+            // Non établi si encore hors bande dans la dernière minute du segment
+            if (lastOutsideBand >= t - 60.0) {
+                unsettled++;
+            } else {
+                double settling = std::max(0.0, lastOutsideBand - segStart);
+                settlingSum += settling;
+                settlingMax = std::max(settlingMax, settling);
+            }
+        }
+        stepUp = std::isnan(segTarget) || newTarget >= segTarget;
+        segStart = std::isnan(segTarget) ? -1 : t; // Le premier segment n'est pas une réponse à un échelon
+        segTarget = newTarget;
+        segPeak = -1e9;
+        lastOutsideBand = t;
+    }
+
+    double segTarget = NAN, segStart = -1, segPeak = -1e9, lastOutsideBand = 0;
+    bool stepUp = true;
+    int segments = 0, unsettled = 0;
+    double overshootSum = 0, overshootMax = 0, settlingSum = 0, settlingMax = 0;
+    double squaredError = 0, maxAbsError = 0, energyJ = 0, dutySum = 0, duration = 0;
+    unsigned long switches = 0;
+    bool heaterOn = false;
+};
+
+} // namespace
+
+int runPlantSimulation(int argc, char** argv) {
+    SimOptions opt;
+    for (int i = 0; i < argc; i++) {
+        if (!parseOption(argv[i], opt)) {
+            Serial.printf("Option inconnue : %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (!initNativeSystem()) return 1;
+    SensorManager::setAcquisitionMode(opt.sensorMode);
+
+    config.usePWM = opt.usePWM;
+    if (opt.kp >= 0) config.Kp = opt.kp;
+    if (opt.ki >= 0) config.Ki = opt.ki;
+    if (opt.kd >= 0) config.Kd = opt.kd;
+    if (opt.hysteresis > 0) config.hysteresis = opt.hysteresis;
+    initHeaterLoop();
+    HeaterControl::setPWMMode(config.usePWM);
+    HeaterControl::setHysteresis((int16_t)lroundf(config.hysteresis * 10));
+    HeaterControl::setPIDParameters(config.Kp, config.Ki, config.Kd);
+
+    ThermalPlant plant(opt.plant);
+    ControlMetrics metrics;
+    SafetySystem safety;
+    int maxSafetyLevel = SAFETY_NORMAL;
+
+    const unsigned long startMs = millis();
+    const unsigned long endMs = startMs + (unsigned long)(opt.days * 86400000.0);
+    const double warmupS = opt.warmupHours * 3600.0;
+    const double startEpoch = FakeHardware::getEpoch() + startMs / 1000.0;
+    unsigned long lastStepMs = startMs;
+    unsigned long nextControlMs = startMs;
+
+    while (millis() < endMs) {
+        unsigned long now = millis();
+        double dt = (now - lastStepMs) / 1000.0;
+        double elapsed = (now - startMs) / 1000.0;
+        lastStepMs = now;
+
+        // La commande appliquée pendant le pas est celle du dernier cycle de contrôle
+        int duty = FakeHardware::getAnalogValue(HEATER_PIN);
+        double secondsOfDay = fmod(startEpoch + elapsed, 86400.0);
+        plant.step(dt, duty, secondsOfDay);
+        if (elapsed >= warmupS) {
+            metrics.sample(elapsed, dt, plant.getEnclosureTemperature(),
+                           getCurrentTargetTemperature() / 10.0,
+                           opt.plant.heaterPowerW * duty / 255.0, duty);
+        }
+
+        if (now >= nextControlMs) {
+            nextControlMs += ControlConstants::CONTROL_PERIOD_MS;
+            FakeHardware::setSensorReading(plant.readSensorTemperature(), plant.readSensorHumidity());
+            if (SensorManager::updateSensors()) {
+                int16_t temperature = SensorManager::getCurrentTemperature();
+                if (opt.useHeaterClass) {
+                    HeaterControl::updateControl(temperature, getCurrentTargetTemperature(), config, safety);
+                } else {
+                    controlHeater(temperature);
+                }
+            }
+            SafetySystem::checkConditions(SensorManager::getCurrentTemperature(), SensorManager::getCurrentHumidity());
+            maxSafetyLevel = std::max(maxSafetyLevel, (int)SafetySystem::getCurrentLevel());
+        }
+
+        FakeHardware::advanceMillis(PLANT_STEP_MS);
+    }
+    metrics.finish((millis() - startMs) / 1000.0);
+
+    Serial.printf("Régulation          : %s, %s (Kp=%.2f Ki=%.2f Kd=%.2f, hystérésis %.1f °C)\n",
+                  opt.useHeaterClass ? "HeaterControl" : "controlHeater",
+                  config.usePWM ? "PID/PWM" : "ON/OFF",
+                  config.Kp, config.Ki, config.Kd, config.hysteresis);
+    Serial.printf("Tapis               : %.0f W, ambiant %.1f °C ±%.1f\n",
+                  opt.plant.heaterPowerW, opt.plant.ambientMeanC, opt.plant.ambientDailySwingC);
+    metrics.print();
+    Serial.printf("Lectures capteur    : %lu\n", (unsigned long)FakeHardware::getSensorReadCount());
+    Serial.printf("Niveau sécurité max : %d\n", maxSafetyLevel);
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include "ThermalPlant.h"
+#include <cmath>
+
+ThermalPlant::ThermalPlant(const ThermalPlantParams& params)
+    : p(params), rng(params.seed), noise(0.0, 1.0) {
+    ambientC = p.ambientMeanC;
+    matC = enclosureC = sensorC = ambientC;
+}
+
+void ThermalPlant::step(double dt, int duty, double secondsOfDay) {
+    if (dt <= 0) return;
+
+    // Ambiant : sinusoïde journalière (max à 15h) + marche aléatoire bornée
+    drift += noise(rng) * 0.002 * std::sqrt(dt);
+    if (drift > p.ambientDriftC) drift = p.ambientDriftC;
+    if (drift < -p.ambientDriftC) drift = -p.ambientDriftC;
+    double phase = (secondsOfDay / 86400.0 - 15.0 / 24.0) * 2.0 * M_PI;
+    ambientC = p.ambientMeanC + p.ambientDailySwingC * std::cos(phase) + drift;
+
+    // Bilan thermique (Euler explicite, stable pour dt << Cm / h)
+    double heatW = p.heaterPowerW * (duty < 0 ? 0 : duty > 255 ? 255 : duty) / 255.0;
+    double matToEnclosureW = p.matCouplingW_K * (matC - enclosureC);
+    double lossW = p.enclosureLossW_K * (enclosureC - ambientC);
+    matC += (heatW - matToEnclosureW) * dt / p.matCapacityJ_K;
+    enclosureC += (matToEnclosureW - lossW) * dt / p.enclosureCapacityJ_K;
+
+    // Capteur : filtre du premier ordre
+    double alpha = dt / (p.sensorLagS + dt);
+    sensorC += alpha * (enclosureC - sensorC);
+}
+
+float ThermalPlant::readSensorTemperature() {
+    double value = sensorC + noise(rng) * p.sensorNoiseC;
+    return (float)(std::round(value * 100.0) / 100.0);
+}
+
+float ThermalPlant::readSensorHumidity() {
+    double value = p.humidityMean - (enclosureC - ambientC) * 1.5 + noise(rng) * 0.5;
+    if (value < 0) value = 0;
+    if (value > 100) value = 100;
+    return (float)(std::round(value * 100.0) / 100.0);
+}
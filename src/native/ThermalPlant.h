@@ -0,0 +1,58 @@
+#ifndef THERMAL_PLANT_H
+#define THERMAL_PLANT_H
+
+#include <stdint.h>
+#include <random>
+
+// Modèle thermique simplifié d'un vivarium chauffé par tapis :
+//   - tapis : masse thermique propre, reçoit la puissance électrique (duty 0-255)
+//     et la cède à l'enceinte ;
+//   - enceinte : masse thermique (air + substrat + vitres) avec pertes vers la pièce ;
+//   - pièce : température ambiante avec cycle jour/nuit et dérive aléatoire bornée ;
+//   - capteur : retard du premier ordre (boîtier), bruit gaussien et quantification.
+struct ThermalPlantParams {
+    double heaterPowerW = 25.0;        // Puissance du tapis à duty 255
+    double matCapacityJ_K = 300.0;     // Capacité thermique du tapis
+    double matCouplingW_K = 2.0;       // Échange tapis -> enceinte
+    double enclosureCapacityJ_K = 6000.0;
+    double enclosureLossW_K = 1.0;     // Pertes enceinte -> pièce
+    double ambientMeanC = 20.0;
+    double ambientDailySwingC = 3.0;   // Amplitude du cycle jour/nuit (max à 15h)
+    double ambientDriftC = 1.0;        // Borne de la dérive aléatoire lente
+    double sensorLagS = 60.0;          // Constante de temps du capteur
+    double sensorNoiseC = 0.05;        // Écart-type du bruit de mesure
+    double humidityMean = 55.0;
+    uint32_t seed = 1;
+};
+
+class ThermalPlant {
+public:
+    explicit ThermalPlant(const ThermalPlantParams& params);
+
+    /**
+     * @brief Avance le modèle.
+     * @param dtSeconds Durée du pas (quelques secondes au plus).
+     * @param duty Commande du chauffage (0-255, valeur de analogWrite).
+     * @param secondsOfDay Heure du jour, pour le cycle ambiant.
+     */
+    void step(double dtSeconds, int duty, double secondsOfDay);
+
+    double getEnclosureTemperature() const { return enclosureC; }
+    double getMatTemperature() const { return matC; }
+    double getAmbientTemperature() const { return ambientC; }
+
+    /**
+     * @brief Lecture brute du capteur (retard + bruit + résolution 0.01°C).
+     */
+    float readSensorTemperature();
+    float readSensorHumidity();
+
+private:
+    ThermalPlantParams p;
+    double matC, enclosureC, ambientC, sensorC;
+    double drift = 0.0;
+    std::mt19937 rng;
+    std::normal_distribution<double> noise;
+};
+
+#endif // THERMAL_PLANT_H
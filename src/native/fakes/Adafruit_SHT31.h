@@ -0,0 +1,24 @@
+#ifndef ADAFRUIT_SHT31_FAKE_H
+#define ADAFRUIT_SHT31_FAKE_H
+
+#include "Arduino.h"
+
+// Substitut du capteur SHT31 : renvoie les valeurs fixées par
+// FakeHardware::setSensorReading(), ou NAN si le capteur est en panne.
+class Adafruit_SHT31 {
+public:
+    Adafruit_SHT31() {}
+
+    bool begin(uint8_t address = 0x44) {
+        (void)address;
+        return FakeHardware::isSensorPresent();
+    }
+    float readTemperature();
+    float readHumidity();
+    bool readBoth(float* temperature, float* humidity);
+    void reset() {}
+    void heater(bool enabled) { (void)enabled; }
+    bool isHeaterEnabled() { return false; }
+};
+
+#endif // ADAFRUIT_SHT31_FAKE_H
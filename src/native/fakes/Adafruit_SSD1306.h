@@ -0,0 +1,68 @@
+#ifndef ADAFRUIT_SSD1306_FAKE_H
+#define ADAFRUIT_SSD1306_FAKE_H
+
+#include "Arduino.h"
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_SETCONTRAST 0x81
+
+class TwoWire;
+
+// Substitut de l'écran OLED : toutes les primitives de dessin sont sans effet,
+// le texte imprimé est simplement ignoré.
+class Adafruit_SSD1306 : public Print {
+public:
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = nullptr, int8_t rst_pin = -1)
+        : w(w), h(h) {
+        (void)twi;
+        (void)rst_pin;
+    }
+
+    bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0, bool reset = true) {
+        (void)switchvcc;
+        (void)i2caddr;
+        (void)reset;
+        return true;
+    }
+
+    size_t write(uint8_t c) override {
+        (void)c;
+        return 1;
+    }
+    using Print::write;
+
+    void display() { refreshCount++; }
+    void clearDisplay() {}
+    void setTextSize(uint8_t size) { (void)size; }
+    void setTextColor(uint16_t color) { (void)color; }
+    void setTextColor(uint16_t color, uint16_t background) { (void)color; (void)background; }
+    void setCursor(int16_t x, int16_t y) { (void)x; (void)y; }
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+        (void)x0; (void)y0; (void)x1; (void)y1; (void)color;
+    }
+    void drawRect(int16_t x, int16_t y, int16_t rw, int16_t rh, uint16_t color) {
+        (void)x; (void)y; (void)rw; (void)rh; (void)color;
+    }
+    void fillRect(int16_t x, int16_t y, int16_t rw, int16_t rh, uint16_t color) {
+        (void)x; (void)y; (void)rw; (void)rh; (void)color;
+    }
+    void fillScreen(uint16_t color) { (void)color; }
+    void ssd1306_command(uint8_t c) { (void)c; }
+
+    int16_t width() const { return w; }
+    int16_t height() const { return h; }
+
+    /**
+     * @brief Nombre d'appels à display() (transferts I2C sur la cible).
+     */
+    uint32_t getRefreshCount() const { return refreshCount; }
+
+private:
+    int16_t w, h;
+    uint32_t refreshCount = 0;
+};
+
+#endif // ADAFRUIT_SSD1306_FAKE_H
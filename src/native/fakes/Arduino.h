@@ -0,0 +1,72 @@
+#ifndef ARDUINO_FAKE_H
+#define ARDUINO_FAKE_H
+
+// Substitut minimal du coeur Arduino-ESP32 pour l'environnement [env:native].
+// Seules les fonctions utilisées par les modules compilés sur l'hôte sont fournies.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <cmath>
+#include <algorithm>
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "FakeHardware.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT  0x01
+#define OUTPUT 0x03
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+using std::min;
+using std::max;
+using std::abs;
+using std::isnan;
+using std::isinf;
+
+// --- Temps (horloge virtuelle, voir FakeHardware.h) ---
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+
+// --- E/S ---
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+void analogWrite(uint8_t pin, int value);
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+// --- Mémoire (PSRAM = tas de l'hôte) ---
+inline void* ps_malloc(size_t size) { return malloc(size); }
+inline void* ps_calloc(size_t n, size_t size) { return calloc(n, size); }
+inline void* ps_realloc(void* ptr, size_t size) { return realloc(ptr, size); }
+
+// --- Port série (redirigé vers stdout) ---
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+#endif // ARDUINO_FAKE_H
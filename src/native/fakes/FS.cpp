@@ -0,0 +1,217 @@
+#include "FS.h"
+#include "LittleFS.h"
+
+fs::LittleFSFS LittleFS;
+
+namespace fs {
+
+// ========================================
+// FICHIER
+// ========================================
+
+File::File(FS* owner, std::shared_ptr<FakeNode> node, const std::string& path, bool readable, bool writable, bool append)
+    : owner(owner), node(node), fullPath(path), readable(readable), writable(writable), append(append) {
+    if (append && node) pos = node->data.size();
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+    if (!node || !writable || node->directory) return 0;
+    if (append) pos = node->data.size();
+    if (pos + size > node->data.size()) node->data.resize(pos + size);
+    memcpy(node->data.data() + pos, buffer, size);
+    pos += size;
+    return size;
+}
+
+int File::available() {
+    if (!node || !readable || node->directory) return 0;
+    return pos < node->data.size() ? (int)(node->data.size() - pos) : 0;
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+    if (!available()) return -1;
+    return node->data[pos];
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    size_t remaining = (size_t)available();
+    size_t count = size < remaining ? size : remaining;
+    if (count) memcpy(buffer, node->data.data() + pos, count);
+    pos += count;
+    return count;
+}
+
+bool File::seek(uint32_t offset, SeekMode mode) {
+    if (!node || node->directory) return false;
+    size_t target = offset;
+    if (mode == SeekCur) target = pos + offset;
+    else if (mode == SeekEnd) target = node->data.size() + offset;
+    if (target > node->data.size()) return false;
+    pos = target;
+    return true;
+}
+
+size_t File::size() const {
+    return node && !node->directory ? node->data.size() : 0;
+}
+
+void File::close() {
+    node.reset();
+    owner = nullptr;
+}
+
+const char* File::name() const {
+    size_t slash = fullPath.rfind('/');
+    return slash == std::string::npos ? fullPath.c_str() : fullPath.c_str() + slash + 1;
+}
+
+File File::openNextFile(const char* mode) {
+    if (!owner || !isDirectory()) return File();
+    std::vector<std::string> entries = owner->children(fullPath);
+    if (childIndex >= entries.size()) return File();
+    return owner->open(entries[childIndex++].c_str(), mode);
+}
+
+// ========================================
+// SYSTÈME DE FICHIERS
+// ========================================
+
+std::string FS::normalize(const char* path) {
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    while (p.size() > 1 && p.back() == '/') p.pop_back();
+    return p;
+}
+
+std::string FS::parentOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == 0 || slash == std::string::npos ? "/" : path.substr(0, slash);
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+    std::string p = normalize(path);
+    std::string m = mode ? mode : "r";
+    bool plus = m.find('+') != std::string::npos;
+
+    auto it = nodes.find(p);
+    if (p == "/") {
+        auto root = std::make_shared<FakeNode>();
+        root->directory = true;
+        return File(this, root, p, true, false, false);
+    }
+
+    if (m[0] == 'r') {
+        if (it == nodes.end()) return File();
+        return File(this, it->second, p, true, plus, false);
+    }
+
+    std::string parent = parentOf(p);
+    if (parent != "/" && !exists(parent.c_str())) {
+        if (!create) return File();
+        mkdir(parent.c_str());
+    }
+    if (it != nodes.end() && it->second->directory) return File();
+
+    std::shared_ptr<FakeNode> node;
+    if (it == nodes.end()) {
+        node = std::make_shared<FakeNode>();
+        nodes[p] = node;
+    } else {
+        node = it->second;
+    }
+    if (m[0] == 'w') node->data.clear();
+    return File(this, node, p, plus, true, m[0] == 'a');
+}
+
+bool FS::exists(const char* path) {
+    std::string p = normalize(path);
+    return p == "/" || nodes.count(p) > 0;
+}
+
+bool FS::remove(const char* path) {
+    auto it = nodes.find(normalize(path));
+    if (it == nodes.end() || it->second->directory) return false;
+    nodes.erase(it);
+    return true;
+}
+
+bool FS::rename(const char* from, const char* to) {
+    std::string src = normalize(from);
+    std::string dst = normalize(to);
+    auto it = nodes.find(src);
+    if (it == nodes.end()) return false;
+    if (it->second->directory) {
+        if (!children(src).empty()) return false;
+    }
+    std::shared_ptr<FakeNode> node = it->second;
+    nodes.erase(it);
+    nodes[dst] = node;
+    return true;
+}
+
+bool FS::mkdir(const char* path) {
+    std::string p = normalize(path);
+    if (p == "/") return true;
+    auto it = nodes.find(p);
+    if (it != nodes.end()) return it->second->directory;
+    std::string parent = parentOf(p);
+    if (parent != "/" && !mkdir(parent.c_str())) return false;
+    auto node = std::make_shared<FakeNode>();
+    node->directory = true;
+    nodes[p] = node;
+    return true;
+}
+
+bool FS::rmdir(const char* path) {
+    std::string p = normalize(path);
+    auto it = nodes.find(p);
+    if (it == nodes.end() || !it->second->directory) return false;
+    if (!children(p).empty()) return false;
+    nodes.erase(it);
+    return true;
+}
+
+std::vector<std::string> FS::children(const std::string& dir) const {
+    std::vector<std::string> result;
+    std::string prefix = dir == "/" ? "/" : dir + "/";
+    for (auto it = nodes.lower_bound(prefix); it != nodes.end(); ++it) {
+        const std::string& p = it->first;
+        if (p.compare(0, prefix.size(), prefix) != 0) break;
+        if (p.find('/', prefix.size()) == std::string::npos) result.push_back(p);
+    }
+    return result;
+}
+
+void FS::clear() {
+    nodes.clear();
+}
+
+size_t FS::storedBytes() const {
+    size_t total = 0;
+    for (const auto& entry : nodes) total += entry.second->data.size();
+    return total;
+}
+
+// ========================================
+// LITTLEFS
+// ========================================
+
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+    (void)formatOnFail;
+    (void)basePath;
+    (void)maxOpenFiles;
+    (void)partitionLabel;
+    return true;
+}
+
+bool LittleFSFS::format() {
+    clear();
+    return true;
+}
+
+} // namespace fs
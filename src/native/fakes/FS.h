@@ -0,0 +1,115 @@
+#ifndef FS_FAKE_H
+#define FS_FAKE_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+// Système de fichiers en mémoire reproduisant l'API fs::FS / fs::File de
+// l'ESP32 (sémantique LittleFS : répertoires explicites, rmdir sur
+// répertoire vide uniquement, rename écrasant la destination).
+namespace fs {
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+struct FakeNode {
+    bool directory = false;
+    std::vector<uint8_t> data;
+};
+
+class FS;
+
+class File : public Stream {
+public:
+    File() {}
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t* buffer, size_t size);
+    size_t readBytes(char* buffer, size_t length) override { return read((uint8_t*)buffer, length); }
+
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const { return pos; }
+    size_t size() const;
+    void flush() override {}
+    void close();
+    time_t getLastWrite() { return 0; }
+
+    const char* path() const { return fullPath.c_str(); }
+    const char* name() const;
+    bool isDirectory() const { return node && node->directory; }
+    File openNextFile(const char* mode = "r");
+    void rewindDirectory() { childIndex = 0; }
+
+    operator bool() const { return node != nullptr; }
+
+private:
+    friend class FS;
+    File(FS* owner, std::shared_ptr<FakeNode> node, const std::string& path, bool readable, bool writable, bool append);
+
+    FS* owner = nullptr;
+    std::shared_ptr<FakeNode> node;
+    std::string fullPath;
+    size_t pos = 0;
+    size_t childIndex = 0;
+    bool readable = false;
+    bool writable = false;
+    bool append = false;
+};
+
+class FS {
+public:
+    File open(const char* path, const char* mode = "r", bool create = false);
+    File open(const String& path, const char* mode = "r", bool create = false) {
+        return open(path.c_str(), mode, create);
+    }
+
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* from, const char* to);
+    bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+    bool mkdir(const char* path);
+    bool mkdir(const String& path) { return mkdir(path.c_str()); }
+    bool rmdir(const char* path);
+    bool rmdir(const String& path) { return rmdir(path.c_str()); }
+
+    /**
+     * @brief Liste les chemins complets des enfants directs d'un répertoire.
+     */
+    std::vector<std::string> children(const std::string& dir) const;
+
+    /**
+     * @brief Vide entièrement le système de fichiers simulé.
+     */
+    void clear();
+
+    /**
+     * @brief Nombre total d'octets de données stockés.
+     */
+    size_t storedBytes() const;
+
+protected:
+    std::map<std::string, std::shared_ptr<FakeNode>> nodes;
+    static std::string normalize(const char* path);
+    static std::string parentOf(const std::string& path);
+};
+
+} // namespace fs
+
+using fs::FS;
+using fs::File;
+
+#endif // FS_FAKE_H
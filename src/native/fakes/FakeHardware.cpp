@@ -0,0 +1,312 @@
+#include "FakeHardware.h"
+#include "Arduino.h"
+#include "Adafruit_SHT31.h"
+#include "Wire.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <map>
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+namespace {
+    uint64_t nowMicros = 0;
+    time_t epochAtBoot = 0;
+    std::map<int, int> analogValues;
+    void (*analogHook)(int, int) = nullptr;
+
+    float sensorTemperature = 22.0f;
+    float sensorHumidity = 50.0f;
+    bool sensorPresent = true;
+    bool sensorFailing = false;
+    uint32_t sensorReads = 0;
+
+    // État du SHT31 vu depuis le bus I2C
+    const uint8_t SHT31_ADDRESS = 0x44;
+    const uint64_t SHT31_CONVERSION_US = 15000;
+    const uint64_t SHT31_PERIODIC_US = 500000;
+    bool sht31Converting = false;
+    bool sht31Periodic = false;
+    bool sht31FrameRequested = false;
+    uint64_t sht31ConversionStart = 0;
+    uint64_t sht31LastFetched = 0;
+
+    uint32_t nvsWrites = 0;
+}
+
+// ========================================
+// POINT DE CONTRÔLE (FakeHardware)
+// ========================================
+
+namespace FakeHardware {
+    void setMillis(unsigned long ms) { nowMicros = (uint64_t)ms * 1000ULL; }
+    void advanceMillis(unsigned long ms) { nowMicros += (uint64_t)ms * 1000ULL; }
+    void advanceMicros(uint64_t us) { nowMicros += us; }
+    uint64_t getMicros() { return nowMicros; }
+
+    void setEpoch(time_t epoch) { epochAtBoot = epoch; }
+    time_t getEpoch() { return epochAtBoot; }
+
+    int getAnalogValue(int pin) {
+        auto it = analogValues.find(pin);
+        return it == analogValues.end() ? 0 : it->second;
+    }
+    void setAnalogWriteHook(void (*hook)(int pin, int value)) { analogHook = hook; }
+
+    void setSensorReading(float temperature, float humidity) {
+        sensorTemperature = temperature;
+        sensorHumidity = humidity;
+    }
+    void setSensorPresent(bool present) { sensorPresent = present; }
+    void setSensorFailing(bool failing) { sensorFailing = failing; }
+    float getSensorTemperature() { return sensorTemperature; }
+    float getSensorHumidity() { return sensorHumidity; }
+    bool isSensorPresent() { return sensorPresent; }
+    bool isSensorFailing() { return sensorFailing; }
+    uint32_t getSensorReadCount() { return sensorReads; }
+
+    uint32_t getNvsWriteCount() { return nvsWrites; }
+    void resetNvsWriteCount() { nvsWrites = 0; }
+    void countNvsWrite() { nvsWrites++; }
+
+    void reset() {
+        nowMicros = 0;
+        epochAtBoot = 0;
+        analogValues.clear();
+        analogHook = nullptr;
+        sensorTemperature = 22.0f;
+        sensorHumidity = 50.0f;
+        sensorPresent = true;
+        sensorFailing = false;
+        sensorReads = 0;
+        sht31Converting = false;
+        sht31Periodic = false;
+        sht31FrameRequested = false;
+        nvsWrites = 0;
+    }
+}
+
+// ========================================
+// COEUR ARDUINO
+// ========================================
+
+unsigned long millis() { return (unsigned long)(nowMicros / 1000ULL); }
+unsigned long micros() { return (unsigned long)nowMicros; }
+void delay(uint32_t ms) { FakeHardware::advanceMillis(ms); }
+void delayMicroseconds(uint32_t us) { FakeHardware::advanceMicros(us); }
+void yield() {}
+
+bool getLocalTime(struct tm* info, uint32_t ms) {
+    (void)ms;
+    if (epochAtBoot == 0) return false;
+    time_t now = epochAtBoot + (time_t)(nowMicros / 1000000ULL);
+    gmtime_r(&now, info);
+    return true;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    analogWrite(pin, val ? 255 : 0);
+}
+
+void analogWrite(uint8_t pin, int value) {
+    analogValues[pin] = value;
+    if (analogHook) analogHook(pin, value);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    if (in_max == in_min) return out_min;
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    return fwrite(buffer, 1, size, stdout);
+}
+
+// ========================================
+// FREERTOS
+// ========================================
+
+void vTaskDelay(TickType_t ticks) {
+    FakeHardware::advanceMillis(ticks * portTICK_PERIOD_MS);
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(millis() / portTICK_PERIOD_MS);
+}
+
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment) {
+    TickType_t wake = *previousWakeTime + increment;
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(wake - now) > 0) vTaskDelay(wake - now);
+    *previousWakeTime = wake;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority, TaskHandle_t* handle, BaseType_t coreId) {
+    // Mono-tâche : le harnais appelle lui-même les fonctions périodiques.
+    (void)task; (void)name; (void)stackDepth; (void)parameters; (void)priority; (void)coreId;
+    if (handle) *handle = NULL;
+    return pdFAIL;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    (void)task;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new FakeSemaphore();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    if (!semaphore) return pdFALSE;
+    if (semaphore->taken) {
+        // Mono-tâche : un mutex déjà pris ne sera jamais rendu, on simule le timeout.
+        if (ticksToWait != portMAX_DELAY) vTaskDelay(ticksToWait);
+        return pdFALSE;
+    }
+    semaphore->taken = true;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    if (!semaphore || !semaphore->taken) return pdFALSE;
+    semaphore->taken = false;
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    delete semaphore;
+}
+
+// ========================================
+// CAPTEUR SHT31
+// ========================================
+
+float Adafruit_SHT31::readTemperature() {
+    float temperature, humidity;
+    return readBoth(&temperature, &humidity) ? temperature : NAN;
+}
+
+float Adafruit_SHT31::readHumidity() {
+    float temperature, humidity;
+    return readBoth(&temperature, &humidity) ? humidity : NAN;
+}
+
+bool Adafruit_SHT31::readBoth(float* temperature, float* humidity) {
+    // Comme le vrai pilote : une mesure "single shot" complète par appel (~15 ms).
+    sensorReads++;
+    delay(15);
+    if (!sensorPresent || sensorFailing) {
+        *temperature = NAN;
+        *humidity = NAN;
+        return false;
+    }
+    *temperature = sensorTemperature;
+    *humidity = sensorHumidity;
+    return true;
+}
+
+// ========================================
+// BUS I2C (SHT31 à 0x44)
+// ========================================
+
+namespace {
+    uint8_t sht31Crc(const uint8_t* data, int length) {
+        uint8_t crc = 0xFF;
+        for (int i = 0; i < length; i++) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    void encodeWord(uint8_t* out, float value, float offset, float scale) {
+        float raw = (value + offset) / scale * 65535.0f;
+        uint16_t word = (uint16_t)constrain(lroundf(raw), 0L, 65535L);
+        out[0] = (uint8_t)(word >> 8);
+        out[1] = (uint8_t)(word & 0xFF);
+        out[2] = sht31Crc(out, 2);
+    }
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    txAddress = address;
+    txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (txLength >= sizeof(txBuffer)) return 0;
+    txBuffer[txLength++] = data;
+    return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    if (txAddress != SHT31_ADDRESS || !sensorPresent) return 2; // NACK adresse
+    if (txLength != 2) return 0;
+    uint16_t command = ((uint16_t)txBuffer[0] << 8) | txBuffer[1];
+
+    if (command == 0x3093) { // BREAK
+        sht31Periodic = false;
+        return 0;
+    }
+    if (sht31Periodic) {
+        // En mode périodique, seules BREAK et FETCH DATA sont acceptées
+        if (command != 0xE000) return 3;
+        sht31FrameRequested = true;
+        return 0;
+    }
+    if (command == 0x2400) {
+        sensorReads++;
+        sht31Converting = true;
+        sht31ConversionStart = nowMicros;
+        return 0;
+    }
+    if (command == 0x2236) {
+        sht31Periodic = true;
+        sht31FrameRequested = false;
+        sht31ConversionStart = nowMicros;
+        sht31LastFetched = 0;
+        return 0;
+    }
+    return 3;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity) {
+    rxLength = 0;
+    rxIndex = 0;
+    if (address != SHT31_ADDRESS || !sensorPresent || sensorFailing) return 0;
+
+    if (sht31Periodic) {
+        if (!sht31FrameRequested) return 0;
+        sht31FrameRequested = false;
+        // Numéro de la dernière mesure terminée (0 = aucune)
+        uint64_t elapsed = nowMicros - sht31ConversionStart;
+        if (elapsed < SHT31_CONVERSION_US) return 0;
+        uint64_t measurement = (elapsed - SHT31_CONVERSION_US) / SHT31_PERIODIC_US + 1;
+        if (measurement == sht31LastFetched) return 0; // Pas de nouvelle mesure
+        sht31LastFetched = measurement;
+        sensorReads++;
+    } else {
+        if (!sht31Converting || nowMicros - sht31ConversionStart < SHT31_CONVERSION_US) return 0;
+        sht31Converting = false;
+    }
+
+    uint8_t frame[6];
+    encodeWord(frame, sensorTemperature, 45.0f, 175.0f);
+    encodeWord(frame + 3, sensorHumidity, 0.0f, 100.0f);
+    rxLength = std::min<uint8_t>(quantity, sizeof(frame));
+    memcpy(rxBuffer, frame, rxLength);
+    return rxLength;
+}
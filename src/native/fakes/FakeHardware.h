@@ -0,0 +1,53 @@
+#ifndef FAKE_HARDWARE_H
+#define FAKE_HARDWARE_H
+
+#include <stdint.h>
+#include <time.h>
+
+// Point de contrôle des substituts matériels de l'environnement [env:native].
+// L'horloge est entièrement virtuelle : millis() ne bouge que lorsque
+// delay(), vTaskDelay() ou advanceMillis() sont appelés, ce qui permet de
+// simuler des semaines de fonctionnement en quelques secondes.
+namespace FakeHardware {
+    // --- Horloge virtuelle ---
+    void setMillis(unsigned long ms);
+    void advanceMillis(unsigned long ms);
+    void advanceMicros(uint64_t us);
+    uint64_t getMicros();
+
+    /**
+     * @brief Fixe l'heure "murale" correspondant à millis() == 0.
+     * Tant qu'elle n'est pas définie, getLocalTime() échoue comme sans NTP.
+     */
+    void setEpoch(time_t epochAtBoot);
+    time_t getEpoch();
+
+    // --- Sorties ---
+    int getAnalogValue(int pin);
+    void setAnalogWriteHook(void (*hook)(int pin, int value));
+
+    // --- Capteur SHT31 ---
+    void setSensorReading(float temperature, float humidity);
+    void setSensorPresent(bool present);
+    void setSensorFailing(bool failing);
+    float getSensorTemperature();
+    float getSensorHumidity();
+    bool isSensorPresent();
+    bool isSensorFailing();
+    /**
+     * @brief Nombre de conversions SHT31 (pilote, "single shot" ou trames périodiques lues).
+     */
+    uint32_t getSensorReadCount();
+
+    // --- NVS (Preferences) ---
+    uint32_t getNvsWriteCount();
+    void resetNvsWriteCount();
+    void countNvsWrite();
+
+    /**
+     * @brief Remet tous les substituts dans leur état initial.
+     */
+    void reset();
+}
+
+#endif // FAKE_HARDWARE_H
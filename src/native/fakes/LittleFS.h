@@ -0,0 +1,30 @@
+#ifndef LITTLEFS_FAKE_H
+#define LITTLEFS_FAKE_H
+
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS : public FS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+               uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs");
+    void end() {}
+    bool format();
+    size_t totalBytes() { return capacity; }
+    size_t usedBytes() { return storedBytes(); }
+
+    /**
+     * @brief Règle la capacité annoncée par totalBytes() (1,5 Mo par défaut).
+     */
+    void setCapacity(size_t bytes) { capacity = bytes; }
+
+private:
+    size_t capacity = 1536 * 1024;
+};
+
+} // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+#endif // LITTLEFS_FAKE_H
@@ -0,0 +1,67 @@
+#include "Preferences.h"
+
+namespace {
+    // Contenu NVS partagé entre toutes les instances, comme sur la cible.
+    std::map<std::string, std::map<std::string, std::vector<uint8_t>>> storage;
+}
+
+bool Preferences::begin(const char* name, bool ro, const char* partitionLabel) {
+    (void)partitionLabel;
+    current = &storage[name ? name : ""];
+    readOnly = ro;
+    return true;
+}
+
+void Preferences::end() {
+    current = nullptr;
+    readOnly = true;
+}
+
+bool Preferences::clear() {
+    if (!current || readOnly) return false;
+    current->clear();
+    FakeHardware::countNvsWrite();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!current || readOnly) return false;
+    FakeHardware::countNvsWrite();
+    return current->erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    return find(key) != nullptr;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    const std::vector<uint8_t>* raw = find(key);
+    if (!raw || raw->empty()) return defaultValue;
+    return String((const char*)raw->data());
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    const std::vector<uint8_t>* raw = find(key);
+    return raw ? raw->size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLen) {
+    const std::vector<uint8_t>* raw = find(key);
+    if (!raw || raw->size() > maxLen) return 0;
+    memcpy(buffer, raw->data(), raw->size());
+    return raw->size();
+}
+
+size_t Preferences::putRaw(const char* key, const void* value, size_t len) {
+    if (!current || readOnly || !key) return 0;
+    const uint8_t* bytes = (const uint8_t*)value;
+    (*current)[key] = std::vector<uint8_t>(bytes, bytes + len);
+    FakeHardware::countNvsWrite();
+    return len;
+}
+
+const std::vector<uint8_t>* Preferences::find(const char* key) const {
+    if (!current || !key) return nullptr;
+    auto it = current->find(key);
+    return it == current->end() ? nullptr : &it->second;
+}
@@ -0,0 +1,58 @@
+#ifndef PREFERENCES_FAKE_H
+#define PREFERENCES_FAKE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+// Substitut en mémoire de la bibliothèque Preferences (NVS).
+// Chaque put*() compte une écriture flash via FakeHardware::countNvsWrite().
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBool(const char* key, bool value) { return putRaw(key, &value, sizeof(value)); }
+    size_t putUChar(const char* key, uint8_t value) { return putRaw(key, &value, sizeof(value)); }
+    size_t putShort(const char* key, int16_t value) { return putRaw(key, &value, sizeof(value)); }
+    size_t putInt(const char* key, int32_t value) { return putRaw(key, &value, sizeof(value)); }
+    size_t putUInt(const char* key, uint32_t value) { return putRaw(key, &value, sizeof(value)); }
+    size_t putFloat(const char* key, float value) { return putRaw(key, &value, sizeof(value)); }
+    size_t putString(const char* key, const char* value) { return putRaw(key, value, strlen(value) + 1); }
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+    size_t putBytes(const char* key, const void* value, size_t len) { return putRaw(key, value, len); }
+
+    bool getBool(const char* key, bool defaultValue = false) { return getValue(key, defaultValue); }
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return getValue(key, defaultValue); }
+    int16_t getShort(const char* key, int16_t defaultValue = 0) { return getValue(key, defaultValue); }
+    int32_t getInt(const char* key, int32_t defaultValue = 0) { return getValue(key, defaultValue); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return getValue(key, defaultValue); }
+    float getFloat(const char* key, float defaultValue = NAN) { return getValue(key, defaultValue); }
+    String getString(const char* key, const String& defaultValue = String());
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buffer, size_t maxLen);
+
+private:
+    typedef std::map<std::string, std::vector<uint8_t>> Namespace;
+
+    Namespace* current = nullptr;
+    bool readOnly = true;
+
+    size_t putRaw(const char* key, const void* value, size_t len);
+    const std::vector<uint8_t>* find(const char* key) const;
+
+    template <typename T>
+    T getValue(const char* key, T defaultValue) {
+        const std::vector<uint8_t>* raw = find(key);
+        if (!raw || raw->size() != sizeof(T)) return defaultValue;
+        T value;
+        memcpy(&value, raw->data(), sizeof(T));
+        return value;
+    }
+};
+
+#endif // PREFERENCES_FAKE_H
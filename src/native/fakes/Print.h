@@ -0,0 +1,59 @@
+#ifndef PRINT_FAKE_H
+#define PRINT_FAKE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include "WString.h"
+
+// Équivalent hôte de la classe Print d'Arduino (utilisée par Serial,
+// l'écran et ArduinoJson pour la sérialisation vers un flux).
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) {
+            if (!write(*buffer++)) break;
+            n++;
+        }
+        return n;
+    }
+    size_t write(const char* str) {
+        return str ? write((const uint8_t*)str, strlen(str)) : 0;
+    }
+    size_t write(const char* buffer, size_t size) {
+        return write((const uint8_t*)buffer, size);
+    }
+
+    size_t print(const char* str) { return write(str); }
+    size_t print(const String& str) { return write(str.c_str(), str.length()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value) { return printf("%d", value); }
+    size_t print(unsigned int value) { return printf("%u", value); }
+    size_t print(long value) { return printf("%ld", value); }
+    size_t print(unsigned long value) { return printf("%lu", value); }
+    size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& value) { return print(value) + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buffer[256];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        if (len < 0) return 0;
+        if ((size_t)len >= sizeof(buffer)) len = sizeof(buffer) - 1;
+        return write((const uint8_t*)buffer, (size_t)len);
+    }
+
+    virtual void flush() {}
+};
+
+#endif // PRINT_FAKE_H
@@ -0,0 +1,8 @@
+#ifndef WPROGRAM_FAKE_H
+#define WPROGRAM_FAKE_H
+
+// Les bibliothèques Arduino historiques (PID_v1) incluent WProgram.h
+// lorsque la macro ARDUINO n'est pas définie, ce qui est le cas sur l'hôte.
+#include "Arduino.h"
+
+#endif // WPROGRAM_FAKE_H
@@ -0,0 +1,160 @@
+#ifndef WSTRING_FAKE_H
+#define WSTRING_FAKE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+// Équivalent hôte de la classe String d'Arduino, adossé à std::string.
+class String {
+public:
+    String() {}
+    String(const char* str) : data(str ? str : "") {}
+    String(const std::string& str) : data(str) {}
+    String(const String& other) = default;
+    String(String&& other) = default;
+    explicit String(char c) : data(1, c) {}
+    explicit String(int value) : data(std::to_string(value)) {}
+    explicit String(unsigned int value) : data(std::to_string(value)) {}
+    explicit String(long value) : data(std::to_string(value)) {}
+    explicit String(unsigned long value) : data(std::to_string(value)) {}
+    explicit String(long long value) : data(std::to_string(value)) {}
+    explicit String(unsigned long long value) : data(std::to_string(value)) {}
+    explicit String(float value, unsigned int decimals = 2) { fromDouble(value, decimals); }
+    explicit String(double value, unsigned int decimals = 2) { fromDouble(value, decimals); }
+
+    String& operator=(const String& other) = default;
+    String& operator=(String&& other) = default;
+    String& operator=(const char* str) {
+        data = str ? str : "";
+        return *this;
+    }
+
+    const char* c_str() const { return data.c_str(); }
+    unsigned int length() const { return (unsigned int)data.length(); }
+    bool isEmpty() const { return data.empty(); }
+    void reserve(unsigned int size) { data.reserve(size); }
+
+    bool concat(const char* str) {
+        if (str) data += str;
+        return true;
+    }
+    bool concat(const String& str) {
+        data += str.data;
+        return true;
+    }
+    bool concat(char c) {
+        data += c;
+        return true;
+    }
+
+    String& operator+=(const String& rhs) { data += rhs.data; return *this; }
+    String& operator+=(const char* rhs) { concat(rhs); return *this; }
+    String& operator+=(char rhs) { data += rhs; return *this; }
+
+    char operator[](unsigned int index) const { return index < data.size() ? data[index] : 0; }
+    char charAt(unsigned int index) const { return (*this)[index]; }
+
+    bool equals(const String& other) const { return data == other.data; }
+    bool equals(const char* other) const { return data == (other ? other : ""); }
+    bool operator==(const String& rhs) const { return equals(rhs); }
+    bool operator==(const char* rhs) const { return equals(rhs); }
+    bool operator!=(const String& rhs) const { return !equals(rhs); }
+    bool operator!=(const char* rhs) const { return !equals(rhs); }
+    bool operator<(const String& rhs) const { return data < rhs.data; }
+
+    bool startsWith(const String& prefix) const { return data.compare(0, prefix.data.size(), prefix.data) == 0; }
+    bool endsWith(const String& suffix) const {
+        return data.size() >= suffix.data.size() &&
+               data.compare(data.size() - suffix.data.size(), suffix.data.size(), suffix.data) == 0;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t pos = data.find(c, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    int indexOf(const String& str, unsigned int from = 0) const {
+        size_t pos = data.find(str.data, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    int lastIndexOf(char c) const {
+        size_t pos = data.rfind(c);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+
+    String substring(unsigned int begin) const {
+        return begin >= data.size() ? String() : String(data.substr(begin));
+    }
+    String substring(unsigned int begin, unsigned int end) const {
+        if (begin > end) std::swap(begin, end);
+        if (begin >= data.size()) return String();
+        return String(data.substr(begin, end - begin));
+    }
+
+    void replace(const String& find, const String& replace) {
+        if (find.data.empty()) return;
+        size_t pos = 0;
+        while ((pos = data.find(find.data, pos)) != std::string::npos) {
+            data.replace(pos, find.data.size(), replace.data);
+            pos += replace.data.size();
+        }
+    }
+    void remove(unsigned int index, unsigned int count = (unsigned int)-1) {
+        if (index < data.size()) data.erase(index, count);
+    }
+    void trim() {
+        size_t first = data.find_first_not_of(" \t\r\n");
+        size_t last = data.find_last_not_of(" \t\r\n");
+        data = first == std::string::npos ? std::string() : data.substr(first, last - first + 1);
+    }
+    void toLowerCase() { for (auto& c : data) c = (char)tolower((unsigned char)c); }
+    void toUpperCase() { for (auto& c : data) c = (char)toupper((unsigned char)c); }
+
+    long toInt() const { return strtol(data.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(data.c_str(), nullptr); }
+    double toDouble() const { return strtod(data.c_str(), nullptr); }
+
+    std::string::const_iterator begin() const { return data.begin(); }
+    std::string::const_iterator end() const { return data.end(); }
+
+private:
+    std::string data;
+
+    void fromDouble(double value, unsigned int decimals) {
+        char buffer[48];
+        snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+        data = buffer;
+    }
+};
+
+// Utilisé par ArduinoJson pour reconnaître les concaténations de String.
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+    StringSumHelper(const char* p) : String(p) {}
+};
+
+inline StringSumHelper operator+(const String& lhs, const String& rhs) {
+    StringSumHelper result(lhs);
+    result += rhs;
+    return result;
+}
+inline StringSumHelper operator+(const String& lhs, const char* rhs) {
+    StringSumHelper result(lhs);
+    result += rhs;
+    return result;
+}
+inline StringSumHelper operator+(const char* lhs, const String& rhs) {
+    StringSumHelper result(lhs);
+    result += rhs;
+    return result;
+}
+inline StringSumHelper operator+(const String& lhs, char rhs) {
+    StringSumHelper result(lhs);
+    result += rhs;
+    return result;
+}
+
+#endif // WSTRING_FAKE_H
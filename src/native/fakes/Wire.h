@@ -0,0 +1,35 @@
+#ifndef WIRE_FAKE_H
+#define WIRE_FAKE_H
+
+#include "Arduino.h"
+
+// Substitut du bus I2C : seul le SHT31 (0x44) répond. Il décode les
+// commandes "single shot", périodique, FETCH DATA et BREAK et renvoie des
+// trames de 6 octets (avec CRC) construites à partir de
+// FakeHardware::setSensorReading(). Comme le vrai capteur sans étirement
+// d'horloge, une lecture avant la fin de la conversion est refusée (NACK).
+class TwoWire {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) {
+        (void)sda; (void)scl; (void)frequency;
+        return true;
+    }
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity);
+    int available() { return rxLength - rxIndex; }
+    int read() { return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1; }
+
+private:
+    uint8_t txAddress = 0;
+    uint8_t txBuffer[8] = {};
+    uint8_t txLength = 0;
+    uint8_t rxBuffer[8] = {};
+    uint8_t rxLength = 0;
+    uint8_t rxIndex = 0;
+};
+
+extern TwoWire Wire;
+
+#endif // WIRE_FAKE_H
@@ -0,0 +1,28 @@
+#ifndef FREERTOS_FAKE_H
+#define FREERTOS_FAKE_H
+
+#include <stdint.h>
+
+// Types et macros FreeRTOS minimaux pour l'environnement [env:native].
+// L'hôte est mono-tâche : les primitives de synchronisation n'attendent jamais.
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 25
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((TickType_t)(ms) * configTICK_RATE_HZ) / 1000))
+
+// Sections critiques : rien à exclure sur l'hôte mono-tâche.
+typedef struct { int locked; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+#define portENTER_CRITICAL(mux) ((mux)->locked = 1)
+#define portEXIT_CRITICAL(mux) ((mux)->locked = 0)
+
+#endif // FREERTOS_FAKE_H
@@ -0,0 +1,18 @@
+#ifndef FREERTOS_SEMPHR_FAKE_H
+#define FREERTOS_SEMPHR_FAKE_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+struct FakeSemaphore {
+    bool taken = false;
+};
+
+typedef FakeSemaphore* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+
+#endif // FREERTOS_SEMPHR_FAKE_H
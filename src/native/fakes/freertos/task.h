@@ -0,0 +1,19 @@
+#ifndef FREERTOS_TASK_FAKE_H
+#define FREERTOS_TASK_FAKE_H
+
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+// Sur l'hôte, attendre revient à faire avancer l'horloge virtuelle.
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment);
+TickType_t xTaskGetTickCount();
+
+// Aucune tâche n'est créée sur l'hôte (retourne pdFAIL, *handle = NULL).
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority, TaskHandle_t* handle, BaseType_t coreId);
+void vTaskDelete(TaskHandle_t task);
+
+#endif // FREERTOS_TASK_FAKE_H
@@ -0,0 +1,112 @@
+// Point d'entrée de l'environnement [env:native].
+//
+//   pio run -e native
+//   .pio/build/native/program bench [cycles] [--sensor=library|single|periodic]
+//                                              débit de la chaîne de contrôle
+//   .pio/build/native/program sim [--options]  simulation en boucle fermée
+//                                              (voir PlantSimulator.cpp)
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include <chrono>
+#include "NativeHarness.h"
+#include "../config/SystemConfig.h"
+#include "../config/ConfigManager.h"
+#include "../sensors/SensorManager.h"
+#include "../sensors/SafetySystem.h"
+#include "../hardware/HeaterControl.h"
+#include "../control/HeaterLoop.h"
+#include "../utils/Logger.h"
+
+using namespace HardwareConstants;
+
+// Équivalents des objets globaux définis dans main.cpp sur la cible
+SystemConfig config;
+Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, nullptr, -1);
+
+SystemConfig& getGlobalConfig() {
+    return config;
+}
+
+bool initNativeSystem() {
+    FakeHardware::reset();
+    FakeHardware::setEpoch(1751328000); // 01/07/2025 00:00 UTC
+    setLogLevel(LOG_LEVEL_ERROR);
+
+    if (!ConfigManager::initialize() || !ConfigManager::loadConfig(config)) {
+        LOG_ERROR("NATIVE", "Échec initialisation configuration");
+        return false;
+    }
+    SemaphoreHandle_t i2cMutex = xSemaphoreCreateMutex();
+    SensorManager::setI2CMutex(i2cMutex);
+    SafetySystem::setI2CMutex(i2cMutex);
+    if (!SensorManager::initialize()) {
+        LOG_ERROR("NATIVE", "Échec initialisation capteurs");
+        return false;
+    }
+    SafetySystem::initialize();
+    initHeaterLoop();
+    return HeaterControl::initialize(HEATER_PIN);
+}
+
+bool parseSensorMode(const char* value, SensorAcquisitionMode& mode) {
+    if (strcmp(value, "library") == 0) mode = SENSOR_ACQ_LIBRARY;
+    else if (strcmp(value, "single") == 0) mode = SENSOR_ACQ_SINGLE_SHOT;
+    else if (strcmp(value, "periodic") == 0) mode = SENSOR_ACQ_PERIODIC;
+    else return false;
+    return true;
+}
+
+int runControlBenchmark(int argc, char** argv) {
+    unsigned long cycles = 1000000UL;
+    SensorAcquisitionMode sensorMode = SENSOR_ACQ_SINGLE_SHOT;
+    for (int i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "--sensor=", 9) == 0) {
+            if (!parseSensorMode(argv[i] + 9, sensorMode)) {
+                Serial.printf("Option inconnue : %s\n", argv[i]);
+                return 2;
+            }
+        } else {
+            cycles = strtoul(argv[i], nullptr, 10);
+        }
+    }
+    if (!initNativeSystem()) return 1;
+    SensorManager::setAcquisitionMode(sensorMode);
+
+    SafetySystem safety;
+    unsigned long heatingCycles = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (unsigned long i = 0; i < cycles; i++) {
+        // Oscillation lente de +/-1°C autour de la consigne
+        float temperature = config.getSetpointFloat() + (float)((i / 60) % 20) / 10.0f - 1.0f;
+        FakeHardware::setSensorReading(temperature, 55.0f);
+
+        if (SensorManager::updateSensors()) {
+            HeaterControl::updateControl(SensorManager::getCurrentTemperature(), config.setpoint, config, safety);
+            if (HeaterControl::isHeating()) heatingCycles++;
+        }
+        SafetySystem::checkConditions(SensorManager::getCurrentTemperature(), SensorManager::getCurrentHumidity());
+        FakeHardware::advanceMillis(2000);
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Serial.printf("Cycles simulés   : %lu (%.1f h virtuelles)\n", cycles, millis() / 3600000.0);
+    Serial.printf("Cycles de chauffe: %lu\n", heatingCycles);
+    Serial.printf("Conversions SHT31: %lu (%.2f par cycle)\n",
+                  (unsigned long)FakeHardware::getSensorReadCount(),
+                  cycles > 0 ? (double)FakeHardware::getSensorReadCount() / cycles : 0.0);
+    Serial.printf("Niveau sécurité  : %d\n", SafetySystem::getCurrentLevel());
+    Serial.printf("Durée réelle     : %.3f s (%.0f cycles/s)\n", elapsed, elapsed > 0 ? cycles / elapsed : 0.0);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "sim") == 0) {
+        return runPlantSimulation(argc - 2, argv + 2);
+    }
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return runControlBenchmark(argc - 2, argv + 2);
+    }
+    return runControlBenchmark(argc - 1, argv + 1);
+}
@@ -1,4 +1,5 @@
 #include "SafetySystem.h"
+#include "SensorManager.h"
 #include "../utils/Logger.h"
 #include <Adafruit_SSD1306.h>
 
@@ -17,6 +18,15 @@ bool SafetySystem::emergencyShutdown = false;
 String SafetySystem::lastErrorMessage = "";
 int16_t SafetySystem::lastKnownGoodTemp = 220; // 22.0°C
 float SafetySystem::lastKnownGoodHum = 50.0f;
+SemaphoreHandle_t SafetySystem::i2cMutex = NULL;
+unsigned long SafetySystem::displayHoldUntil = 0;
+portMUX_TYPE SafetySystem::screenMux = portMUX_INITIALIZER_UNLOCKED;
+SafetySystem::SafetyScreen SafetySystem::pendingScreen = SafetySystem::SCREEN_RECOVERY;
+char SafetySystem::screenReason[22] = "";
+bool SafetySystem::screenDirty = false;
+
+// Durée d'affichage du message de reprise avant le retour aux pages normales
+static const unsigned long RECOVERY_DISPLAY_MS = 2000;
 
 void SafetySystem::initialize() {
     currentLevel = SAFETY_NORMAL;
@@ -37,6 +47,12 @@ void SafetySystem::initialize() {
 void SafetySystem::checkConditions(int16_t currentTemp, float currentHum) {
     unsigned long now = millis();
     
+    // Dernière lecture réussie (le délai de grâce court depuis initialize())
+    unsigned long lastUpdate = SensorManager::getLastUpdateTime();
+    if (lastUpdate > lastSensorRead) {
+        lastSensorRead = lastUpdate;
+    }
+    
     // Vérifier le timeout des capteurs
     if (now - lastSensorRead > SafetyConstants::SENSOR_TIMEOUT) {
         escalateSafety(SAFETY_CRITICAL, 
@@ -132,68 +148,19 @@ void SafetySystem::escalateSafety(SafetyLevel newLevel, const String& reason) {
 
 void SafetySystem::activateWarningMode(const String& reason) {
     LOG_WARN("SAFETY", "MODE ALERTE ACTIVÉ: %s", reason.c_str());
-    
-    display.clearDisplay();
-    display.setTextSize(1);
-    display.setCursor(0, 0);
-    display.println("ALERTE! ");
-    display.setCursor(0, 12);
-    display.println(reason.substring(0, 21));
-    display.setCursor(0, 24);
-    display.printf("Temp: %.1fC", (float)lastKnownGoodTemp / 10.0f);
-    display.setCursor(0, 36);
-    display.printf("Hum: %.0f%%", lastKnownGoodHum);
-    display.setCursor(0, 48);
-    display.println("Surveillance++");
-    display.display();
+    postScreen(SCREEN_WARNING, reason);
 }
 
 void SafetySystem::activateCriticalMode(const String& reason) {
     LOG_ERROR("SAFETY", "MODE CRITIQUE ACTIVÉ: %s", reason.c_str());
-    
-    display.clearDisplay();
-    display.setTextSize(1);
-    display.setCursor(0, 0);
-    display.println("MODE CRITIQUE");
-    display.drawLine(0, 10, display.width(), 10, SSD1306_WHITE);
-    display.setCursor(0, 15);
-    display.println("Chauffage OFF");
-    display.setCursor(0, 27);
-    display.println(reason.substring(0, 21));
-    display.setCursor(0, 39);
-    display.println("Verification...");
-    display.setCursor(0, 51);
-    display.printf("T:%.1f H:%.0f%%", (float)lastKnownGoodTemp / 10.0f, lastKnownGoodHum);
-    display.display();
+    postScreen(SCREEN_CRITICAL, reason);
 }
 
 void SafetySystem::activateEmergencyMode(const String& reason) {
     LOG_ERROR("SAFETY", "MODE URGENCE ACTIVÉ: %s", reason.c_str());
     
     emergencyShutdown = true;
-    
-    static bool blinkState = false;
-    blinkState = !blinkState;
-    
-    display.clearDisplay();
-    if (blinkState) {
-        display.fillScreen(SSD1306_WHITE);
-        display.setTextColor(SSD1306_BLACK);
-    } else {
-        display.setTextColor(SSD1306_WHITE);
-    }
-    
-    display.setTextSize(2);
-    display.setCursor(0, 0);
-    display.println("URGENCE! ");
-    display.setTextSize(1);
-    display.setCursor(0, 20);
-    display.println("ARRET COMPLET");
-    display.setCursor(0, 32);
-    display.println(reason.substring(0, 21));
-    display.setCursor(0, 44);
-    display.println("Verif. capteurs");
-    display.display();
+    postScreen(SCREEN_EMERGENCY, reason);
 }
 
 void SafetySystem::downgradeSafety() {
@@ -218,18 +185,8 @@ void SafetySystem::exitSafeMode() {
     humidityOutOfRangeCount = 0;
     lastErrorMessage = "";
     
-    display.clearDisplay();
-    display.setTextSize(1);
-    display.setCursor(0, 0);
-    display.println("SYSTEME OK");
-    display.setCursor(0, 15);
-    display.println("Reprise normale");
-    display.setCursor(0, 30);
-    display.printf("Temp: %.1fC", (float)lastKnownGoodTemp / 10.0f);
-    display.setCursor(0, 45);
-    display.printf("Hum: %.0f%%", lastKnownGoodHum);
-    display.display();
-    delay(2000);
+    postScreen(SCREEN_RECOVERY, "");
+    displayHoldUntil = millis() + RECOVERY_DISPLAY_MS;
 }
 
 void SafetySystem::resetSafety() {
@@ -261,4 +218,101 @@ float SafetySystem::getLastKnownGoodHum() {
 
 String SafetySystem::getLastErrorMessage() {
     return lastErrorMessage;
-}
\ No newline at end of file
+}
+
+bool SafetySystem::ownsDisplay() {
+    return currentLevel != SAFETY_NORMAL || (long)(displayHoldUntil - millis()) > 0;
+}
+
+void SafetySystem::postScreen(SafetyScreen screen, const String& reason) {
+    // Tâche de régulation : l'écran est dessiné plus tard par renderDisplay()
+    portENTER_CRITICAL(&screenMux);
+    pendingScreen = screen;
+    snprintf(screenReason, sizeof(screenReason), "%s", reason.c_str());
+    screenDirty = true;
+    portEXIT_CRITICAL(&screenMux);
+}
+
+void SafetySystem::renderDisplay() {
+    portENTER_CRITICAL(&screenMux);
+    bool dirty = screenDirty;
+    SafetyScreen screen = pendingScreen;
+    char reason[sizeof(screenReason)];
+    memcpy(reason, screenReason, sizeof(reason));
+    portEXIT_CRITICAL(&screenMux);
+    if (!dirty) return;
+
+    float temp = (float)lastKnownGoodTemp / 10.0f;
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+    switch (screen) {
+        case SCREEN_WARNING:
+            display.setCursor(0, 0);
+            display.println("ALERTE! ");
+            display.setCursor(0, 12);
+            display.println(reason);
+            display.setCursor(0, 24);
+            display.printf("Temp: %.1fC", temp);
+            display.setCursor(0, 36);
+            display.printf("Hum: %.0f%%", lastKnownGoodHum);
+            display.setCursor(0, 48);
+            display.println("Surveillance++");
+            break;
+        case SCREEN_CRITICAL:
+            display.setCursor(0, 0);
+            display.println("MODE CRITIQUE");
+            display.drawLine(0, 10, display.width(), 10, SSD1306_WHITE);
+            display.setCursor(0, 15);
+            display.println("Chauffage OFF");
+            display.setCursor(0, 27);
+            display.println(reason);
+            display.setCursor(0, 39);
+            display.println("Verification...");
+            display.setCursor(0, 51);
+            display.printf("T:%.1f H:%.0f%%", temp, lastKnownGoodHum);
+            break;
+        case SCREEN_EMERGENCY: {
+            static bool blinkState = false;
+            blinkState = !blinkState;
+            if (blinkState) {
+                display.fillScreen(SSD1306_WHITE);
+                display.setTextColor(SSD1306_BLACK);
+            }
+            display.setTextSize(2);
+            display.setCursor(0, 0);
+            display.println("URGENCE! ");
+            display.setTextSize(1);
+            display.setCursor(0, 20);
+            display.println("ARRET COMPLET");
+            display.setCursor(0, 32);
+            display.println(reason);
+            display.setCursor(0, 44);
+            display.println("Verif. capteurs");
+            break;
+        }
+        case SCREEN_RECOVERY:
+            display.setCursor(0, 0);
+            display.println("SYSTEME OK");
+            display.setCursor(0, 15);
+            display.println("Reprise normale");
+            display.setCursor(0, 30);
+            display.printf("Temp: %.1fC", temp);
+            display.setCursor(0, 45);
+            display.printf("Hum: %.0f%%", lastKnownGoodHum);
+            break;
+    }
+    display.setTextColor(SSD1306_WHITE);
+
+    // Bus I2C occupé : l'écran sera redessiné au prochain appel
+    if (i2cMutex == NULL || xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(50)) != pdTRUE) {
+        return;
+    }
+    display.display();
+    xSemaphoreGive(i2cMutex);
+
+    // Un nouvel écran posté pendant le dessin reste à afficher
+    portENTER_CRITICAL(&screenMux);
+    if (pendingScreen == screen && strcmp(screenReason, reason) == 0) screenDirty = false;
+    portEXIT_CRITICAL(&screenMux);
+}
@@ -2,6 +2,8 @@
 #define SAFETY_SYSTEM_H
 
 #include "../config/SystemConfig.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 // La classe SafetySystem surveille en permanence les conditions du système
 // pour prévenir les situations dangereuses (surchauffe, panne de capteur, etc.).
@@ -67,8 +69,34 @@ public:
      * @return Le niveau de sécurité actuel.
      */
     static SafetyLevel getCurrentLevel() { return currentLevel; }
+
+    /**
+     * @brief Indique si l'écran affiche un message de sécurité à ne pas écraser.
+     * @return true tant qu'une alerte est active ou que le message de reprise est affiché.
+     */
+    static bool ownsDisplay();
+
+    /**
+     * @brief Dessine le dernier écran de sécurité demandé, s'il n'est pas
+     * encore affiché. Appelée par la tâche principale, seule à dessiner sur
+     * l'écran : la tâche de régulation ne fait que poster l'écran voulu.
+     */
+    static void renderDisplay();
+
+    // Configuration du mutex I2C (partagé avec le capteur et l'affichage principal)
+    static void setI2CMutex(SemaphoreHandle_t mutex) { i2cMutex = mutex; }
     
 private:
+    enum SafetyScreen { SCREEN_WARNING, SCREEN_CRITICAL, SCREEN_EMERGENCY, SCREEN_RECOVERY };
+
+    static SemaphoreHandle_t i2cMutex;
+    static unsigned long displayHoldUntil;
+    static portMUX_TYPE screenMux;
+    static SafetyScreen pendingScreen;    // Protégés par screenMux
+    static char screenReason[22];         // Une ligne de l'écran
+    static bool screenDirty;
+
+    static void postScreen(SafetyScreen screen, const String& reason);
     static void activateWarningMode(const String& reason);
     static void activateCriticalMode(const String& reason);
     static void activateEmergencyMode(const String& reason);
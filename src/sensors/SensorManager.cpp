@@ -1,6 +1,29 @@
 #include "SensorManager.h"
 #include "SafetySystem.h"
 #include "../utils/Logger.h"
+#include <Wire.h>
+
+// Commandes SHT31 (datasheet Sensirion, §4)
+namespace {
+    const uint8_t SHT31_ADDRESS = 0x44;
+    const uint16_t SHT31_CMD_SINGLE_SHOT = 0x2400;  // Haute répétabilité, sans étirement d'horloge
+    const uint16_t SHT31_CMD_PERIODIC = 0x2236;     // Haute répétabilité, 2 mesures/s
+    const uint16_t SHT31_CMD_FETCH_DATA = 0xE000;
+    const uint16_t SHT31_CMD_BREAK = 0x3093;        // Arrêt de l'acquisition périodique
+    const uint32_t SHT31_CONVERSION_MS = 16;        // 15.5 ms max en haute répétabilité
+
+    // CRC-8 du SHT31 : polynôme 0x31, valeur initiale 0xFF
+    uint8_t sht31Crc(const uint8_t* data, int length) {
+        uint8_t crc = 0xFF;
+        for (int i = 0; i < length; i++) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+            }
+        }
+        return crc;
+    }
+}
 
 // Variables statiques
 Adafruit_SHT31 SensorManager::sht31 = Adafruit_SHT31();
@@ -14,9 +37,16 @@ float SensorManager::minHum = INFINITY;
 bool SensorManager::dataValid = false;
 unsigned long SensorManager::lastUpdateTime = 0;
 int SensorManager::consecutiveFailures = 0;
+SeqLock<SensorSample> SensorManager::latest;
+uint32_t SensorManager::sampleSequence = 0;
+TaskHandle_t SensorManager::taskHandle = NULL;
+uint32_t SensorManager::taskPeriodMs = 1000;
+SensorAcquisitionMode SensorManager::acquisitionMode = SENSOR_ACQ_SINGLE_SHOT;
+SensorManager::Sht31State SensorManager::sht31State = SensorManager::SHT31_IDLE;
+unsigned long SensorManager::conversionStartMs = 0;
 
 bool SensorManager::initialize() {
-    if (!sht31.begin(0x44)) {
+    if (!sht31.begin(SHT31_ADDRESS)) {
         LOG_ERROR("SENSORS", "Capteur SHT31 non trouvé !");
         return false;
     }
@@ -41,6 +71,8 @@ bool SensorManager::updateSensors() {
             consecutiveFailures = 0;
             
             updateStatistics(currentTemp, currentHum);
+            sampleSequence++;
+            publishSample();
             
             LOG_DEBUG("SENSORS", "Capteurs mis à jour: %.1f°C, %.0f%%", (float)currentTemp / 10.0f, currentHum);
             return true;
@@ -51,13 +83,59 @@ bool SensorManager::updateSensors() {
     
     consecutiveFailures++;
     if (consecutiveFailures >= SafetyConstants::MAX_CONSECUTIVE_FAILURES) {
-        dataValid = false;
+        if (dataValid) {
+            dataValid = false;
+            publishSample();
+        }
         LOG_ERROR("SENSORS", "Capteurs en échec après %d tentatives", consecutiveFailures);
     }
     
     return false;
 }
 
+void SensorManager::publishSample() {
+    SensorSample sample;
+    sample.temperature = currentTemp;
+    sample.humidity = currentHum;
+    sample.timestampMs = lastUpdateTime;
+    sample.sequence = sampleSequence;
+    sample.valid = dataValid;
+    latest.write(sample);
+}
+
+bool SensorManager::startTask(uint32_t periodMs) {
+    if (taskHandle != NULL) {
+        LOG_WARN("SENSORS", "Tâche capteur déjà démarrée");
+        return false;
+    }
+    taskPeriodMs = periodMs;
+    xTaskCreatePinnedToCore(
+        taskLoop,
+        "Sensors",
+        ControlConstants::SENSOR_TASK_STACK,
+        NULL,
+        ControlConstants::SENSOR_TASK_PRIORITY,
+        &taskHandle,
+        ControlConstants::SENSOR_TASK_CORE
+    );
+    if (taskHandle == NULL) {
+        LOG_ERROR("SENSORS", "Échec création tâche capteur");
+        return false;
+    }
+    LOG_INFO("SENSORS", "Tâche capteur démarrée (%lu ms)", (unsigned long)periodMs);
+    return true;
+}
+
+void SensorManager::taskLoop(void* arg) {
+    // Pas de watchdog ici : une tâche bloquée est détectée par SafetySystem
+    // (SENSOR_TIMEOUT sans nouvelle mesure) et coupe le chauffage.
+    TickType_t lastWake = xTaskGetTickCount();
+    for (;;) {
+        updateSensors();
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(taskPeriodMs));
+    }
+}
+
 bool SensorManager::readTemperatureHumidity(float& temperature, float& humidity) {
     return readSensorWithRetry(temperature, humidity);
 }
@@ -68,12 +146,8 @@ bool SensorManager::readSensorWithRetry(float& temp, float& hum, int maxRetries)
         return false;
     }
     
-    // Tentative d'acquisition du mutex avec timeout
-    if (xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
-        LOG_WARN("SENSORS", "Timeout acquisition mutex I2C pour capteur");
-        return false;
-    }
-    
+    // Le mutex n'est pris que pendant les transactions I2C, jamais pendant
+    // une conversion ni pendant l'attente entre deux tentatives.
     bool success = false;
     for (int attempt = 0; attempt < maxRetries && !success; attempt++) {
         if (attempt > 0) {
@@ -81,20 +155,118 @@ bool SensorManager::readSensorWithRetry(float& temp, float& hum, int maxRetries)
             vTaskDelay(pdMS_TO_TICKS(50));
         }
         
-        temp = sht31.readTemperature();
-        hum = sht31.readHumidity();
+        success = acquisitionMode == SENSOR_ACQ_LIBRARY ? readLibrary(temp, hum) : readFrame(temp, hum);
         
-        if (!isnan(temp) && !isnan(hum)) {
-            success = true;
+        if (success) {
             LOG_DEBUG("SENSORS", "Lecture capteur réussie : %.1f°C, %.0f%%", temp, hum);
         } else {
             LOG_WARN("SENSORS", "Échec lecture capteur (tentative %d)", attempt + 1);
         }
     }
-    // Libération du mutex
-    xSemaphoreGive(i2cMutex);
     return success;
+}
+
+bool SensorManager::readLibrary(float& temp, float& hum) {
+    // Chaque appel du pilote déclenche sa propre conversion et l'attend bus pris
+    if (xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        LOG_WARN("SENSORS", "Timeout acquisition mutex I2C pour capteur");
+        return false;
+    }
+    temp = sht31.readTemperature();
+    hum = sht31.readHumidity();
+    xSemaphoreGive(i2cMutex);
+    return !isnan(temp) && !isnan(hum);
+}
 
+bool SensorManager::readFrame(float& temp, float& hum) {
+    if (sht31State == SHT31_IDLE && !startMeasurement()) {
+        return false;
+    }
+    
+    // Conversion en cours : la tâche cède le cœur au lieu d'attendre bus pris
+    unsigned long elapsed = millis() - conversionStartMs;
+    if (elapsed < SHT31_CONVERSION_MS) {
+        vTaskDelay(pdMS_TO_TICKS(SHT31_CONVERSION_MS - elapsed));
+    }
+    return fetchMeasurement(temp, hum);
+}
+
+bool SensorManager::startMeasurement() {
+    if (xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        LOG_WARN("SENSORS", "Timeout acquisition mutex I2C pour capteur");
+        return false;
+    }
+    bool periodic = acquisitionMode == SENSOR_ACQ_PERIODIC;
+    bool ok = sendCommand(periodic ? SHT31_CMD_PERIODIC : SHT31_CMD_SINGLE_SHOT);
+    xSemaphoreGive(i2cMutex);
+    
+    if (!ok) {
+        LOG_WARN("SENSORS", "Commande de mesure SHT31 non acquittée");
+        return false;
+    }
+    sht31State = periodic ? SHT31_PERIODIC : SHT31_CONVERTING;
+    conversionStartMs = millis();
+    return true;
+}
+
+bool SensorManager::fetchMeasurement(float& temp, float& hum) {
+    if (xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        LOG_WARN("SENSORS", "Timeout acquisition mutex I2C pour capteur");
+        return false;
+    }
+    bool ok = true;
+    if (sht31State == SHT31_PERIODIC) {
+        ok = sendCommand(SHT31_CMD_FETCH_DATA);
+    }
+    ok = ok && receiveFrame(temp, hum);
+    if (!ok && sht31State == SHT31_PERIODIC) {
+        // Capteur réinitialisé ou sans nouvelle mesure : l'acquisition sera relancée
+        sendCommand(SHT31_CMD_BREAK);
+    }
+    xSemaphoreGive(i2cMutex);
+    
+    // Une commande "single shot" ne donne qu'une trame
+    if (sht31State == SHT31_CONVERTING || !ok) {
+        sht31State = SHT31_IDLE;
+    }
+    return ok;
+}
+
+bool SensorManager::sendCommand(uint16_t command) {
+    Wire.beginTransmission(SHT31_ADDRESS);
+    Wire.write((uint8_t)(command >> 8));
+    Wire.write((uint8_t)(command & 0xFF));
+    return Wire.endTransmission() == 0;
+}
+
+bool SensorManager::receiveFrame(float& temp, float& hum) {
+    // Trame : T (2 octets) + CRC, HR (2 octets) + CRC. NACK si la mesure n'est pas prête.
+    uint8_t frame[6];
+    if (Wire.requestFrom(SHT31_ADDRESS, (uint8_t)sizeof(frame)) != sizeof(frame)) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(frame); i++) {
+        frame[i] = Wire.read();
+    }
+    if (sht31Crc(frame, 2) != frame[2] || sht31Crc(frame + 3, 2) != frame[5]) {
+        LOG_WARN("SENSORS", "CRC SHT31 invalide");
+        return false;
+    }
+    uint16_t rawTemp = ((uint16_t)frame[0] << 8) | frame[1];
+    uint16_t rawHum = ((uint16_t)frame[3] << 8) | frame[4];
+    temp = -45.0f + 175.0f * rawTemp / 65535.0f;
+    hum = 100.0f * rawHum / 65535.0f;
+    return true;
+}
+
+void SensorManager::setAcquisitionMode(SensorAcquisitionMode mode) {
+    if (sht31State == SHT31_PERIODIC && i2cMutex && xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        sendCommand(SHT31_CMD_BREAK);
+        xSemaphoreGive(i2cMutex);
+    }
+    sht31State = SHT31_IDLE;
+    acquisitionMode = mode;
+    LOG_INFO("SENSORS", "Mode d'acquisition SHT31 : %d", (int)mode);
 }
 
 bool SensorManager::validateReading(int16_t temp, float hum) {
@@ -143,5 +315,6 @@ void SensorManager::resetStatistics() {
     minHum = INFINITY;
     consecutiveFailures = 0;
     dataValid = false;
+    publishSample();
     LOG_INFO("SENSORS", "Statistiques capteurs réinitialisées");
 }
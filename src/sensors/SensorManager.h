@@ -2,21 +2,63 @@
 #define SENSOR_MANAGER_H
 
 #include "../config/SystemConfig.h"
+#include "../utils/SeqLock.h"
 #include <Adafruit_SHT31.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
+#include <freertos/task.h>
+
+// Dernière mesure publiée par la tâche capteur.
+// Les valeurs sont celles de la dernière lecture valide.
+struct SensorSample {
+    int16_t temperature = 0;      // En int16_t (ex: 255 pour 25.5°C)
+    float humidity = NAN;
+    uint32_t timestampMs = 0;     // millis() de la dernière lecture valide
+    uint32_t sequence = 0;        // Incrémenté à chaque lecture valide (0 = aucune)
+    bool valid = false;           // false après MAX_CONSECUTIVE_FAILURES échecs
+};
+
+// Modes d'acquisition du SHT31.
+enum SensorAcquisitionMode {
+    SENSOR_ACQ_LIBRARY = 0,     // readTemperature() + readHumidity() : deux conversions bloquantes
+    SENSOR_ACQ_SINGLE_SHOT = 1, // Une commande, attente hors mutex, une trame de 6 octets (CRC)
+    SENSOR_ACQ_PERIODIC = 2     // Le capteur mesure seul (2 mesures/s), lecture par FETCH DATA
+};
 
 // La classe SensorManager gère la lecture des capteurs (température et humidité).
 // Elle est conçue comme une classe statique pour un accès centralisé.
+//
+// La lecture I2C est réservée à une tâche productrice (startTask) qui publie
+// chaque mesure dans une boîte aux lettres SeqLock. Les lecteurs (régulation,
+// sécurité, affichage, serveur web) n'attendent jamais le bus ni un mutex.
 class SensorManager {
 public:
     static bool initialize();
     static bool readTemperatureHumidity(float& temperature, float& humidity);
+
+    /**
+     * @brief Lit le capteur (avec reprises) et publie le résultat.
+     * @return true si une nouvelle mesure valide a été publiée, false sinon.
+     */
     static bool updateSensors();
-    static int16_t getCurrentTemperature() { return currentTemp; } // Retourne int16_t
-    static float getCurrentHumidity() { return currentHum; }
-    static bool isDataValid() { return dataValid; }
-    static unsigned long getLastUpdateTime() { return lastUpdateTime; }
+
+    /**
+     * @brief Démarre la tâche productrice qui appelle updateSensors() périodiquement.
+     * @param periodMs La période de lecture en millisecondes.
+     * @return true si la tâche a été créée, false sinon.
+     */
+    static bool startTask(uint32_t periodMs);
+
+    /**
+     * @brief Copie la dernière mesure publiée, sans verrou.
+     * @return La dernière mesure.
+     */
+    static SensorSample getLatestSample() { return latest.read(); }
+
+    static int16_t getCurrentTemperature() { return latest.read().temperature; } // Retourne int16_t
+    static float getCurrentHumidity() { return latest.read().humidity; }
+    static bool isDataValid() { return latest.read().valid; }
+    static unsigned long getLastUpdateTime() { return latest.read().timestampMs; }
     
     // Statistiques
     static int16_t getMaxTemperature() { return maxTemp; } // Retourne int16_t
@@ -28,18 +70,48 @@ public:
     // Configuration du mutex I2C
     static void setI2CMutex(SemaphoreHandle_t mutex) { i2cMutex = mutex; }
 
+    /**
+     * @brief Change le mode d'acquisition (à appeler avant startTask()).
+     * Arrête l'acquisition périodique du capteur si elle était active.
+     * @param mode Le nouveau mode.
+     */
+    static void setAcquisitionMode(SensorAcquisitionMode mode);
+    static SensorAcquisitionMode getAcquisitionMode() { return acquisitionMode; }
+
 private:
+    // État de la machine de mesure SHT31 (modes SINGLE_SHOT et PERIODIC)
+    enum Sht31State {
+        SHT31_IDLE,        // Aucune mesure en cours
+        SHT31_CONVERTING,  // Commande "single shot" envoyée, conversion en cours
+        SHT31_PERIODIC     // Acquisition périodique active
+    };
+
     static Adafruit_SHT31 sht31;
     static SemaphoreHandle_t i2cMutex;
+    static SeqLock<SensorSample> latest;
+    static uint32_t sampleSequence;
+    static TaskHandle_t taskHandle;
+    static uint32_t taskPeriodMs;
     static int16_t currentTemp, maxTemp, minTemp; // Changé en int16_t
     static float currentHum, maxHum, minHum;
     static bool dataValid;
     static unsigned long lastUpdateTime;
     static int consecutiveFailures;
+    static SensorAcquisitionMode acquisitionMode;
+    static Sht31State sht31State;
+    static unsigned long conversionStartMs;
     
     static bool readSensorWithRetry(float& temp, float& hum, int maxRetries = 3);
     static bool validateReading(int16_t temp, float hum);
     static void updateStatistics(int16_t temp, float hum); // Accepte int16_t pour temp
+    static bool readLibrary(float& temp, float& hum);
+    static bool readFrame(float& temp, float& hum);
+    static bool startMeasurement();
+    static bool fetchMeasurement(float& temp, float& hum);
+    static bool sendCommand(uint16_t command);
+    static bool receiveFrame(float& temp, float& hum);
+    static void publishSample();
+    static void taskLoop(void* arg);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Boîte aux lettres "dernière valeur" à un seul écrivain et plusieurs lecteurs,
+// sans verrou ni section critique.
+//
+// Deux emplacements alternent : l'écrivain remplit celui qui ne contient pas
+// la dernière valeur publiée, puis publie. Le compteur de séquence est impair
+// pendant une écriture. Un lecteur copie toujours le dernier emplacement
+// complet et ne recommence que si l'écrivain a entamé une seconde écriture
+// pendant la copie. Un lecteur plus prioritaire qui préempte l'écrivain sur
+// le même cœur ne tourne donc jamais en boucle.
+//
+// T doit être trivialement copiable (structure de valeurs, sans String).
+template <typename T>
+class SeqLock {
+public:
+    /**
+     * @brief Publie une nouvelle valeur. Un seul écrivain à la fois.
+     * @param value La valeur à publier.
+     */
+    void write(const T& value) {
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        uint32_t writeNumber = (seq >> 1) + 1;
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slots[writeNumber & 1] = value;
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copie la dernière valeur publiée (valeur par défaut de T avant toute écriture).
+     * @return Une copie cohérente de la valeur.
+     */
+    T read() const {
+        T copy;
+        for (;;) {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            uint32_t completed = before >> 1;
+            copy = slots[completed & 1];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint32_t after = sequence.load(std::memory_order_relaxed);
+            // L'emplacement lu n'est réécrit qu'à partir de l'écriture completed + 2
+            if (after < 2 * completed + 3) {
+                return copy;
+            }
+        }
+    }
+
+    /**
+     * @brief Nombre de valeurs publiées depuis le démarrage.
+     */
+    uint32_t version() const {
+        return sequence.load(std::memory_order_acquire) >> 1;
+    }
+
+private:
+    T slots[2] = {};
+    std::atomic<uint32_t> sequence{0};
+};
+
+#endif // SEQ_LOCK_H
@@ -1,73 +1,140 @@
 #include "AppWebServer.h"
 #include "../config/SystemConfig.h"
 #include "../config/ConfigManager.h"
+#include "../config/SeasonalJobs.h"
 #include "../sensors/SensorManager.h"
 #include "../sensors/SafetySystem.h"
+#include "../control/HeaterLoop.h"
+#include "../control/ControlTask.h"
+#include "../control/SystemSnapshot.h"
+#include "../history/HistoryLog.h"
+#include "../history/HistoryRollup.h"
 #include "../utils/Logger.h"
 #include "../hardware/CameraManager.h" // Ajout de l'en-tête
+#include "../hardware/MotionRecorder.h"
+#include "../hardware/Timelapse.h"
+#include "JsonWriter.h"
+#include "RequestBody.h"
 #include <ArduinoJson.h>
 #include <WiFi.h>
 #include <LittleFS.h>
 
 // Forward declarations for functions in main.cpp
 SystemConfig& getGlobalConfig();
-double getHeaterOutput();
-HistoryRecord* getHistory();
-int getHistoryIndex();
-bool isHistoryFull();
-int16_t getCurrentTargetTemperature();
 
-void AppWebServerManager::setupRoutes(AsyncWebServer& server) {
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/index.html", "text/html");
-    });
+AsyncEventSource AppWebServerManager::events("/api/events");
 
-    server.on("/css/style.css", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/css/style.css", "text/css");
-    });
+// Champs de SystemConfig exposés par /api/config et /api/profiles/load, sous
+// le nom du membre. tempCurve (tableau) est écrit à part.
+#define CONFIG_JSON_FIELDS(X) \
+    X(currentProfileName) X(usePWM) X(weatherModeEnabled) X(cameraEnabled) \
+    X(cameraResolution) X(motionRecording) X(timelapseMinutes) \
+    X(useTempCurve) X(useLimitTemp) X(hysteresis) \
+    X(Kp) X(Ki) X(Kd) X(setpoint) X(globalMinTempSet) X(globalMaxTempSet) \
+    X(latitude) X(longitude) X(DST_offset) X(ledState) X(ledBrightness) \
+    X(ledRed) X(ledGreen) X(ledBlue) X(logLevel)
 
-    server.on("/js/main.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/js/main.js", "application/javascript");
-    });
-    server.on("/js/api.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/js/api.js", "application/javascript");
-    });
-    server.on("/js/state.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/js/state.js", "application/javascript");
-    });
-    server.on("/js/utils.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/js/utils.js", "application/javascript");
-    });
-    server.on("/js/ui/camera.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/js/ui/camera.js", "application/javascript");
-    });
-    server.on("/js/ui/configuration.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/js/ui/configuration.js", "application/javascript");
-    });
-    server.on("/js/ui/led.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/js/ui/led.js", "application/javascript");
-    });
-    server.on("/js/ui/map.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/js/ui/map.js", "application/javascript");
-    });
-    server.on("/js/ui/profiles.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/js/ui/profiles.js", "application/javascript");
-    });
-    server.on("/js/ui/seasonal.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/js/ui/seasonal.js", "application/javascript");
-    });
-    server.on("/js/ui/surveillance.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/js/ui/surveillance.js", "application/javascript");
-    });
-    server.on("/js/ui/tabs.js", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/js/ui/tabs.js", "application/javascript");
-    });
-     server.on("/images/favicon.ico", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(LittleFS, "/images/favicon.ico", "image/x-icon");
-    });
+static void writeConfigFields(JsonWriter& json, const SystemConfig& config) {
+#define WRITE_CONFIG_FIELD(name) json.field(#name, config.name);
+    CONFIG_JSON_FIELDS(WRITE_CONFIG_FIELD)
+#undef WRITE_CONFIG_FIELD
+    json.beginArray("tempCurve");
+    for (int i = 0; i < TEMP_CURVE_POINTS; i++) {
+        json.value(config.getTempCurve(i));
+    }
+    json.endArray();
+}
+
+// Le tampon (pile) est copié une seule fois, dans la réponse.
+static void sendJson(AsyncWebServerRequest *request, const JsonWriter& json, int code = 200) {
+    if (json.overflow()) {
+        LOG_ERROR("WEB", "Réponse JSON tronquée pour %s", request->url().c_str());
+        request->send(500, "text/plain", "Réponse trop longue");
+        return;
+    }
+    request->send(code, "application/json", json.c_str());
+}
+
+// Applique un champ de PATCH /api/config : mêmes noms et unités que GET
+// (températures en dixièmes de °C). Renvoie le bit ConfigField du champ, ou 0
+// si la clé est inconnue ou la valeur du mauvais type ou hors limites.
+static uint32_t patchConfigField(SystemConfig& config, const char* key, JsonVariantConst value) {
+    const long TEMP_LOW = lroundf(SafetyConstants::TEMP_EMERGENCY_LOW * 10);
+    const long TEMP_HIGH = lroundf(SafetyConstants::TEMP_EMERGENCY_HIGH * 10);
+
+#define PATCH_BOOL(name, bit) \
+    if (!strcmp(key, #name)) { \
+        if (!value.is<bool>()) return 0; \
+        config.name = value.as<bool>(); \
+        return bit; \
+    }
+#define PATCH_NUMBER(name, type, low, high, bit) \
+    if (!strcmp(key, #name)) { \
+        if (!value.is<type>() || value.as<type>() < (low) || value.as<type>() > (high)) return 0; \
+        config.name = value.as<type>(); \
+        return bit; \
+    }
+
+    PATCH_BOOL(usePWM, CFG_USE_PWM)
+    PATCH_BOOL(weatherModeEnabled, CFG_WEATHER_MODE)
+    PATCH_BOOL(cameraEnabled, CFG_CAMERA_ENABLED)
+    PATCH_BOOL(motionRecording, CFG_MOTION_RECORDING)
+    PATCH_BOOL(useTempCurve, CFG_USE_TEMP_CURVE)
+    PATCH_BOOL(useLimitTemp, CFG_USE_LIMIT_TEMP)
+    PATCH_BOOL(ledState, CFG_LED_STATE)
 
+    PATCH_NUMBER(hysteresis, float, 0.01f, 9.99f, CFG_HYSTERESIS)
+    PATCH_NUMBER(Kp, float, 0.0f, 1000.0f, CFG_KP)
+    PATCH_NUMBER(Ki, float, 0.0f, 1000.0f, CFG_KI)
+    PATCH_NUMBER(Kd, float, 0.0f, 1000.0f, CFG_KD)
+    PATCH_NUMBER(latitude, float, -90.0f, 90.0f, CFG_LATITUDE)
+    PATCH_NUMBER(longitude, float, -180.0f, 180.0f, CFG_LONGITUDE)
+
+    PATCH_NUMBER(setpoint, long, TEMP_LOW, TEMP_HIGH, CFG_SETPOINT)
+    PATCH_NUMBER(globalMinTempSet, long, TEMP_LOW, TEMP_HIGH, CFG_MIN_TEMP)
+    PATCH_NUMBER(globalMaxTempSet, long, TEMP_LOW, TEMP_HIGH, CFG_MAX_TEMP)
+    PATCH_NUMBER(DST_offset, long, -12, 14, CFG_DST_OFFSET)
+    PATCH_NUMBER(ledBrightness, long, 0, 255, CFG_LED_BRIGHTNESS)
+    PATCH_NUMBER(ledRed, long, 0, 255, CFG_LED_RED)
+    PATCH_NUMBER(ledGreen, long, 0, 255, CFG_LED_GREEN)
+    PATCH_NUMBER(ledBlue, long, 0, 255, CFG_LED_BLUE)
+    PATCH_NUMBER(logLevel, long, LOG_LEVEL_NONE, LOG_LEVEL_DEBUG, CFG_LOG_LEVEL)
+    PATCH_NUMBER(timelapseMinutes, long, 0, TimelapseConstants::MAX_INTERVAL_MINUTES, CFG_TIMELAPSE)
+
+#undef PATCH_BOOL
+#undef PATCH_NUMBER
+
+    if (!strcmp(key, "currentProfileName")) {
+        const char* name = value.as<const char*>();
+        if (!name || !*name || strlen(name) > 31) return 0;
+        config.currentProfileName = name;
+        return CFG_PROFILE_NAME;
+    }
+    if (!strcmp(key, "cameraResolution")) {
+        const char* resolution = value.as<const char*>();
+        if (!resolution || CameraManager::stringToFramesize(resolution) == FRAMESIZE_INVALID) return 0;
+        config.cameraResolution = resolution;
+        return CFG_CAMERA_RES;
+    }
+    if (!strcmp(key, "tempCurve")) {
+        JsonArrayConst curve = value.as<JsonArrayConst>();
+        if (curve.isNull() || curve.size() != TEMP_CURVE_POINTS) return 0;
+        for (JsonVariantConst point : curve) {
+            if (!point.is<long>() || point.as<long>() < TEMP_LOW || point.as<long>() > TEMP_HIGH) return 0;
+        }
+        int hour = 0;
+        for (JsonVariantConst point : curve) {
+            config.tempCurve[hour++] = (int16_t)point.as<long>();
+        }
+        return CFG_TEMP_CURVE;
+    }
+    return 0;
+}
+
+void AppWebServerManager::setupRoutes(AsyncWebServer& server) {
     server.on("/api/config", HTTP_GET, handleGetCurrentConfig);
     server.on("/api/config", HTTP_POST, [](AsyncWebServerRequest *req){}, NULL, handleApplyAllSettings);
+    server.on("/api/config", HTTP_PATCH, [](AsyncWebServerRequest *req){}, NULL, handlePatchConfig);
     server.on("/api/save", HTTP_POST, handleSaveConfiguration);
 
     server.on("/api/profiles", HTTP_GET, handleListProfiles);
@@ -79,64 +146,93 @@ void AppWebServerManager::setupRoutes(AsyncWebServer& server) {
     server.on("/api/seasonal/day", HTTP_GET, handleGetDayData);
     server.on("/api/seasonal/day", HTTP_POST, [](AsyncWebServerRequest *req){}, NULL, handleSaveDayData);
     server.on("/api/seasonal/yearly", HTTP_GET, handleGetYearlyTemperatures);
+    server.on("/api/seasonal/upload", HTTP_POST, [](AsyncWebServerRequest *req){}, NULL, handleUploadSeasonalData);
     server.on("/api/seasonal/extend", HTTP_POST, [](AsyncWebServerRequest *req){}, NULL, handleExtendMonthData);
     server.on("/api/seasonal/smooth", HTTP_POST, [](AsyncWebServerRequest *req){}, NULL, handleSmoothMonthData);
     server.on("/api/applyYearlyCurve", HTTP_POST, [](AsyncWebServerRequest *req){}, NULL, handleApplyYearlyCurve);
+    server.on("/api/jobs", HTTP_GET, handleJobStatus);
 
     server.on("/api/status", HTTP_GET, handleStatus);
+    server.on("/api/history/rollup", HTTP_GET, handleHistoryRollup); // Avant /api/history (préfixe)
     server.on("/api/history", HTTP_GET, handleHistory);
+    server.on("/api/history.bin", HTTP_GET, handleHistoryBinary);
     server.on("/api/safety", HTTP_GET, handleSafetyStatus);
 
+    // Statut poussé à chaque cycle ; un client qui se connecte reçoit l'état complet
+    events.onConnect([](AsyncEventSourceClient *client) {
+        SystemSnapshot snapshot = getSystemSnapshot();
+        char message[512];
+        formatStatusEvent(message, sizeof(message), snapshot, nullptr);
+        client->send(message, "status", snapshot.version, WebConstants::EVENT_RECONNECT_MS);
+    });
+    server.addHandler(&events);
+
     server.on("/capture", HTTP_GET, CameraManager::handleCapture);
+    server.on("/mjpeg/info", HTTP_GET, handleMJPEGInfo); // Avant /mjpeg (préfixe)
     server.on("/mjpeg", HTTP_GET, CameraManager::handleStream);
     
     
     server.on("/download/profile", HTTP_GET, handleDownloadProfile);
     server.on("/download/seasonal", HTTP_GET, handleDownloadSeasonalData);
     server.on("/api/camera/set", HTTP_POST, handleSetCamera);
+    server.on("/api/camera/events/frame", HTTP_GET, handleCameraEventFrame); // Avant /api/camera/events (préfixe)
+    server.on("/api/camera/events", HTTP_GET, handleCameraEvents);
+    server.on("/api/timelapse/day", HTTP_GET, Timelapse::handleDay); // Avant /api/timelapse (préfixe)
+    server.on("/api/timelapse", HTTP_GET, handleTimelapse);
+
+    // Fichiers web pré-compressés (utilitaire/build_littlefs.py) : en dernier,
+    // toutes les routes ci-dessus sont prioritaires
+    server.on("/*", HTTP_GET, handleStaticAsset);
+}
+
+void AppWebServerManager::handleStaticAsset(AsyncWebServerRequest *request) {
+    String path = request->url();
+    if (path.endsWith("/")) path += "index.html";
+
+    // Seuls les fichiers compressés à la construction de l'image sont servis
+    // (pas les profils). L'ETag vient de l'en-queue gzip : CRC-32 et taille
+    // du contenu non compressé, donc un hachage du contenu sans calcul ici.
+    File file = LittleFS.open(path + ".gz", "r");
+    if (!file || file.isDirectory() || file.size() < 18) {
+        request->send(404, "text/plain", "Introuvable");
+        return;
+    }
+    uint32_t trailer[2] = { 0, 0 };
+    file.seek(file.size() - sizeof(trailer));
+    file.read((uint8_t*)trailer, sizeof(trailer));
+    file.close();
+    char etag[20];
+    snprintf(etag, sizeof(etag), "\"%08lx%08lx\"", (unsigned long)trailer[0], (unsigned long)trailer[1]);
+
+    AsyncWebServerResponse *response;
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == etag) {
+        response = request->beginResponse(304);
+    } else {
+        // Le fichier .gz est choisi et annoncé (Content-Encoding) par la bibliothèque
+        response = request->beginResponse(LittleFS, path);
+    }
+    response->addHeader("ETag", etag);
+    // /assets/ : noms hachés par utilitaire/build_littlefs.py, jamais réécrits
+    response->addHeader("Cache-Control", path.startsWith("/assets/") ? "public, max-age=31536000, immutable" : "no-cache");
+    request->send(response);
 }
 
 void AppWebServerManager::handleGetCurrentConfig(AsyncWebServerRequest *request) {
     SystemConfig& config = getGlobalConfig();
-    DynamicJsonDocument doc(2048);
-    doc["currentProfileName"] = config.currentProfileName;
-    doc["usePWM"] = config.usePWM;
-    doc["weatherModeEnabled"] = config.weatherModeEnabled;
-    doc["cameraEnabled"] = config.cameraEnabled;
-    doc["cameraResolution"] = config.cameraResolution;
-    doc["useTempCurve"] = config.useTempCurve;
-    doc["useLimitTemp"] = config.useLimitTemp;
-    doc["hysteresis"] = config.hysteresis;
-    doc["Kp"] = config.Kp;
-    doc["Ki"] = config.Ki;
-    doc["Kd"] = config.Kd;
-    doc["setpoint"] = config.setpoint;
-    doc["globalMinTempSet"] = config.globalMinTempSet;
-    doc["globalMaxTempSet"] = config.globalMaxTempSet;
-    JsonArray tempCurve = doc.createNestedArray("tempCurve");
-    for(int i=0; i<TEMP_CURVE_POINTS; i++) {
-        tempCurve.add(config.tempCurve[i]);
-    }
-    doc["latitude"] = config.latitude;
-    doc["longitude"] = config.longitude;
-    doc["DST_offset"] = config.DST_offset;
-    doc["ledState"] = config.ledState;
-    doc["ledBrightness"] = config.ledBrightness;
-    doc["ledRed"] = config.ledRed;
-    doc["ledGreen"] = config.ledGreen;
-    doc["ledBlue"] = config.ledBlue;
-    
-    doc["logLevel"] = config.logLevel;
-    doc["lastSaveTime"] = config.lastSaveTime;
-
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    char buffer[1024];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginObject();
+    writeConfigFields(json, config);
+    json.field("lastSaveTime", config.lastSaveTime);
+    json.endObject();
+    sendJson(request, json);
 }
 
 void AppWebServerManager::handleApplyAllSettings(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total) {
+    RequestBody body;
+    if (!RequestBody::collect(request, data, len, index, total, body)) return;
     DynamicJsonDocument doc(2048);
-    if (deserializeJson(doc, data, len) != DeserializationError::Ok) {
+    if (deserializeJson(doc, body.data(), body.size()) != DeserializationError::Ok) {
         request->send(400, "text/plain", "JSON invalide");
         return;
     }
@@ -153,6 +249,8 @@ void AppWebServerManager::handleApplyAllSettings(AsyncWebServerRequest *request,
     if (doc.containsKey("weatherModeEnabled")) config.weatherModeEnabled = doc["weatherModeEnabled"];
     if (doc.containsKey("cameraEnabled")) config.cameraEnabled = doc["cameraEnabled"];
     if (doc.containsKey("cameraResolution")) config.cameraResolution = doc["cameraResolution"].as<String>();
+    if (doc.containsKey("motionRecording")) config.motionRecording = doc["motionRecording"];
+    if (doc.containsKey("timelapseMinutes")) config.timelapseMinutes = min(doc["timelapseMinutes"].as<unsigned>(), (unsigned)TimelapseConstants::MAX_INTERVAL_MINUTES);
     if (doc.containsKey("useTempCurve")) config.useTempCurve = doc["useTempCurve"];
     if (doc.containsKey("useLimitTemp")) config.useLimitTemp = doc["useLimitTemp"];
     if (doc.containsKey("hysteresis")) config.hysteresis = doc["hysteresis"];
@@ -183,6 +281,49 @@ void AppWebServerManager::handleApplyAllSettings(AsyncWebServerRequest *request,
     request->send(200, "text/plain", "Configuration reçue et sauvegarde demandée.");
 }
 
+void AppWebServerManager::handlePatchConfig(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total) {
+    RequestBody body;
+    if (!RequestBody::collect(request, data, len, index, total, body)) return;
+    DynamicJsonDocument doc(1024);
+    if (deserializeJson(doc, body.data(), body.size()) != DeserializationError::Ok || !doc.is<JsonObject>()) {
+        request->send(400, "text/plain", "JSON invalide");
+        return;
+    }
+    JsonObjectConst patch = doc.as<JsonObjectConst>();
+
+    // Validation sur une copie : la configuration active n'est modifiée
+    // que si tous les champs sont acceptés.
+    SystemConfig& config = getGlobalConfig();
+    SystemConfig candidate = config;
+    uint32_t fields = 0;
+    for (JsonPairConst field : patch) {
+        uint32_t bit = patchConfigField(candidate, field.key().c_str(), field.value());
+        if (bit == 0) {
+            char message[64];
+            snprintf(message, sizeof(message), "Champ invalide : %s", field.key().c_str());
+            request->send(400, "text/plain", message);
+            return;
+        }
+        fields |= bit;
+    }
+    if (!candidate.isValid() || candidate.globalMinTempSet > candidate.globalMaxTempSet) {
+        request->send(400, "text/plain", "Configuration invalide");
+        return;
+    }
+
+    // Seuls les champs reçus sont recopiés, pour ne pas écraser une
+    // modification faite entre-temps par une autre tâche.
+    for (JsonPairConst field : patch) {
+        patchConfigField(config, field.key().c_str(), field.value());
+    }
+    if (fields != 0) ConfigManager::requestSave(fields);
+
+    char buffer[48];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginObject().field("fields", (unsigned long)fields).endObject();
+    sendJson(request, json);
+}
+
 void AppWebServerManager::handleSaveConfiguration(AsyncWebServerRequest *request) {
     SystemConfig& config = getGlobalConfig();
     if (ConfigManager::saveConfig(config)) {
@@ -194,14 +335,14 @@ void AppWebServerManager::handleSaveConfiguration(AsyncWebServerRequest *request
 
 void AppWebServerManager::handleListProfiles(AsyncWebServerRequest *request) {
     std::vector<String> profiles = ConfigManager::listProfiles();
-    DynamicJsonDocument doc(1024);
-    JsonArray array = doc.to<JsonArray>();
+    char buffer[1024];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginArray();
     for (const auto& p : profiles) {
-        array.add(p);
+        json.value(p);
     }
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    json.endArray();
+    sendJson(request, json);
 }
 
 void AppWebServerManager::handleLoadProfile(AsyncWebServerRequest *request) {
@@ -210,38 +351,12 @@ void AppWebServerManager::handleLoadProfile(AsyncWebServerRequest *request) {
         SystemConfig tempConfig; // Utiliser une config temporaire
         if (ConfigManager::loadProfile(profileName, tempConfig)) {
             // Renvoyer la configuration chargée au format JSON
-            DynamicJsonDocument doc(2048);
-            doc["currentProfileName"] = tempConfig.currentProfileName;
-            doc["usePWM"] = tempConfig.usePWM;
-            doc["weatherModeEnabled"] = tempConfig.weatherModeEnabled;
-            doc["cameraEnabled"] = tempConfig.cameraEnabled;
-            doc["cameraResolution"] = tempConfig.cameraResolution;
-            doc["useTempCurve"] = tempConfig.useTempCurve;
-            doc["useLimitTemp"] = tempConfig.useLimitTemp;
-            doc["hysteresis"] = tempConfig.hysteresis;
-            doc["Kp"] = tempConfig.Kp;
-            doc["Ki"] = tempConfig.Ki;
-            doc["Kd"] = tempConfig.Kd;
-            doc["setpoint"] = tempConfig.setpoint;
-            doc["globalMinTempSet"] = tempConfig.globalMinTempSet;
-            doc["globalMaxTempSet"] = tempConfig.globalMaxTempSet;
-            JsonArray tempCurve = doc.createNestedArray("tempCurve");
-            for(int i=0; i<TEMP_CURVE_POINTS; i++) {
-                tempCurve.add(tempConfig.getTempCurve(i));
-            }
-            doc["latitude"] = tempConfig.latitude;
-            doc["longitude"] = tempConfig.longitude;
-            doc["DST_offset"] = tempConfig.DST_offset;
-            doc["ledState"] = tempConfig.ledState;
-            doc["ledBrightness"] = tempConfig.ledBrightness;
-            doc["ledRed"] = tempConfig.ledRed;
-            doc["ledGreen"] = tempConfig.ledGreen;
-            doc["ledBlue"] = tempConfig.ledBlue;
-            doc["logLevel"] = tempConfig.logLevel;
-
-            String response;
-            serializeJson(doc, response);
-            request->send(200, "application/json", response);
+            char buffer[1024];
+            JsonWriter json(buffer, sizeof(buffer));
+            json.beginObject();
+            writeConfigFields(json, tempConfig);
+            json.endObject();
+            sendJson(request, json);
         } else {
             request->send(404, "text/plain", "Profil non trouvé");
         }
@@ -251,8 +366,10 @@ void AppWebServerManager::handleLoadProfile(AsyncWebServerRequest *request) {
 }
 
 void AppWebServerManager::handleSaveProfile(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total) {
+    RequestBody body;
+    if (!RequestBody::collect(request, data, len, index, total, body)) return;
     DynamicJsonDocument doc(2048);
-    if (deserializeJson(doc, data, len) != DeserializationError::Ok) {
+    if (deserializeJson(doc, body.data(), body.size()) != DeserializationError::Ok) {
         request->send(400, "text/plain", "JSON invalide");
         return;
     }
@@ -302,38 +419,108 @@ void AppWebServerManager::handleGetDayData(AsyncWebServerRequest *request) {
     SystemConfig& config = getGlobalConfig();
     float temps[24];
     if (ConfigManager::loadSeasonalData(config.currentProfileName, dayIndex, temps)) {
-        DynamicJsonDocument doc(1024);
-        JsonArray arr = doc.to<JsonArray>();
+        char buffer[192];
+        JsonWriter json(buffer, sizeof(buffer));
+        json.beginArray();
         for(int i=0; i<24; i++) {
-            arr.add((int16_t)(temps[i] * 10)); // Convert to int16_t * 10
+            json.value((int16_t)(temps[i] * 10)); // Convert to int16_t * 10
         }
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response);
+        json.endArray();
+        sendJson(request, json);
     } else {
         request->send(404, "text/plain", "Données non trouvées");
     }
 }
 
+// Lit un jour { "day": 0..365, "temps": [24 valeurs en °C] } en int16_t * 10.
+// Renvoie l'index du jour, -1 s'il est invalide ou hors de [MIN_TEMP, MAX_TEMP].
+static int parseDayObject(JsonObjectConst day, int16_t* tempsInt) {
+    using namespace SeasonalConstants;
+    JsonArrayConst temps = day["temps"];
+    if (!day["day"].is<int>() || temps.size() != HOURS) return -1;
+    int dayIndex = day["day"];
+    if (dayIndex < 0 || dayIndex >= DAYS) return -1;
+    for (int i = 0; i < HOURS; i++) {
+        if (!temps[i].is<float>()) return -1;
+        float tenths = temps[i].as<float>() * 10;
+        if (!(tenths >= MIN_TEMP && tenths <= MAX_TEMP)) return -1;
+        tempsInt[i] = (int16_t)tenths;
+    }
+    return dayIndex;
+}
+
+// Parcourt un tableau de jours en flux : un seul jour analysé à la fois,
+// quelle que soit la taille du corps. Chaque jour est reporté dans 'year'.
+// Renvoie le nombre de jours, -1 si un élément est invalide.
+static int forEachDay(RequestBody& body, int16_t* year) {
+    body.rewind();
+    if (!body.find("[")) return -1;
+    StaticJsonDocument<1024> doc;
+    int16_t temps[SeasonalConstants::HOURS];
+    int count = 0;
+    do {
+        if (deserializeJson(doc, body) != DeserializationError::Ok) return -1;
+        int dayIndex = parseDayObject(doc.as<JsonObjectConst>(), temps);
+        if (dayIndex < 0) return -1;
+        memcpy(year + dayIndex * SeasonalConstants::HOURS, temps, SeasonalConstants::DAY_BYTES);
+        count++;
+    } while (body.findUntil(",", "]"));
+    return count;
+}
+
+// 409 tant qu'un traitement de l'année réécrit temperature.bin
+static bool rejectWhileJobRunning(AsyncWebServerRequest *request) {
+    if (!SeasonalJobs::isRunning()) return false;
+    request->send(409, "text/plain", "Un traitement de l'année est en cours");
+    return true;
+}
+
 void AppWebServerManager::handleSaveDayData(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total) {
-    DynamicJsonDocument doc(1024);
-    if (deserializeJson(doc, data, len) != DeserializationError::Ok) {
-        request->send(400, "text/plain", "JSON invalide");
+    RequestBody body;
+    if (!RequestBody::collect(request, data, len, index, total, body)) return;
+    if (rejectWhileJobRunning(request)) return;
+    SystemConfig& config = getGlobalConfig();
+
+    // Plusieurs jours en une requête : [{ "day", "temps" }, ...], reportés
+    // dans une copie de l'année puis écrits d'un seul tenant (une écriture
+    // au lieu d'une par jour), seulement si tous sont valides
+    const char* start = body.data();
+    while (start < body.data() + body.size() && isspace((unsigned char)*start)) start++;
+    if (start < body.data() + body.size() && *start == '[') {
+        int16_t* year = (int16_t*)ps_malloc(SeasonalConstants::FILE_BYTES);
+        if (!year) year = (int16_t*)malloc(SeasonalConstants::FILE_BYTES);
+        if (!year || !ConfigManager::readSeasonalYear(config.currentProfileName, year)) {
+            free(year);
+            request->send(500, "text/plain", "Erreur sauvegarde");
+            return;
+        }
+        int count = forEachDay(body, year);
+        if (count < 0) {
+            request->send(400, "text/plain", "Jour invalide");
+        } else if (!ConfigManager::writeSeasonalDays(config.currentProfileName, 0, (const uint8_t*)year,
+                                                     SeasonalConstants::DAYS)) {
+            request->send(500, "text/plain", "Erreur sauvegarde");
+        } else {
+            char message[48];
+            snprintf(message, sizeof(message), "%d jours sauvegardés", count);
+            request->send(200, "text/plain", message);
+        }
+        free(year);
         return;
     }
-    int dayIndex = doc["day"];
-    JsonArray tempArray = doc["temps"];
-    float temps[24];
-    for(int i=0; i<24; i++) {
-        temps[i] = tempArray[i].as<float>();
+
+    StaticJsonDocument<1024> doc;
+    if (deserializeJson(doc, body.data(), body.size()) != DeserializationError::Ok) {
+        request->send(400, "text/plain", "JSON invalide");
+        return;
     }
-    SystemConfig& config = getGlobalConfig();
-    // Convertir les floats en int16_t * 10 avant de sauvegarder
-    int16_t tempsInt[24];
-    for(int i=0; i<24; i++) {
-        tempsInt[i] = (int16_t)(temps[i] * 10);
+    int16_t temps[SeasonalConstants::HOURS];
+    int dayIndex = parseDayObject(doc.as<JsonObjectConst>(), temps);
+    if (dayIndex < 0) {
+        request->send(400, "text/plain", "Jour invalide");
+        return;
     }
-    if (ConfigManager::saveSeasonalData(config.currentProfileName, dayIndex, tempsInt)) {
+    if (ConfigManager::saveSeasonalData(config.currentProfileName, dayIndex, temps)) {
         request->send(200, "text/plain", "Données sauvegardées");
     } else {
         request->send(500, "text/plain", "Erreur sauvegarde");
@@ -350,17 +537,127 @@ void AppWebServerManager::handleGetYearlyTemperatures(AsyncWebServerRequest *req
     }
 }
 
+void AppWebServerManager::handleUploadSeasonalData(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total) {
+    using namespace SeasonalConstants;
+    RequestBody body;
+    if (!RequestBody::collect(request, data, len, index, total, body, FILE_BYTES)) return;
+    if (rejectWhileJobRunning(request)) return;
+
+    // Corps brut au format de temperature.bin, à partir du jour ?day= (0 par défaut)
+    int firstDay = request->hasParam("day") ? request->getParam("day")->value().toInt() : 0;
+    int dayCount = body.size() / DAY_BYTES;
+    if (body.size() % DAY_BYTES != 0 || firstDay < 0 || firstDay + dayCount > DAYS) {
+        request->send(400, "text/plain", "Plage de jours invalide");
+        return;
+    }
+    // Le tampon reçu n'est pas forcément aligné : lecture octet par octet
+    const uint8_t* bytes = (const uint8_t*)body.data();
+    for (size_t i = 0; i < body.size(); i += sizeof(int16_t)) {
+        int16_t temp = (int16_t)(bytes[i] | (bytes[i + 1] << 8));
+        if (temp < MIN_TEMP || temp > MAX_TEMP) {
+            request->send(400, "text/plain", "Température hors limites");
+            return;
+        }
+    }
+
+    SystemConfig& config = getGlobalConfig();
+    if (ConfigManager::writeSeasonalDays(config.currentProfileName, firstDay, bytes, dayCount)) {
+        char message[48];
+        snprintf(message, sizeof(message), "%d jours importés", dayCount);
+        request->send(200, "text/plain", message);
+    } else {
+        request->send(500, "text/plain", "Erreur écriture temperature.bin");
+    }
+}
+
+// Réponse des traitements de l'année lancés en tâche de fond : 202 et
+// identifiant à suivre sur /api/jobs, ou 409 si un traitement est en cours.
+static void sendJobAccepted(AsyncWebServerRequest *request, uint32_t job) {
+    if (job == 0) {
+        request->send(409, "text/plain", "Un traitement de l'année est déjà en cours");
+        return;
+    }
+    char buffer[32];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginObject().field("job", (unsigned long)job).endObject();
+    sendJson(request, json, 202);
+}
+
+// Plage de jours d'une requête saisonnière : "month" (0-11), ou "from" et
+// "to" (0-365, to < from pour passer par le 31/12), ou toute l'année.
+static bool readDayRange(JsonObjectConst doc, int& firstDay, int& lastDay) {
+    if (doc.containsKey("month")) {
+        int month = doc["month"] | -1;
+        if (month < 0 || month > 11) return false;
+        SeasonalKernels::monthRange(month, firstDay, lastDay);
+        return true;
+    }
+    firstDay = doc["from"] | 0;
+    lastDay = doc["to"] | (SeasonalConstants::DAYS - 1);
+    return firstDay >= 0 && firstDay < SeasonalConstants::DAYS && lastDay >= 0 && lastDay < SeasonalConstants::DAYS;
+}
+
 void AppWebServerManager::handleExtendMonthData(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total) {
-    request->send(501, "text/plain", "Not Implemented");
+    RequestBody body;
+    if (!RequestBody::collect(request, data, len, index, total, body)) return;
+    StaticJsonDocument<256> doc;
+    if (deserializeJson(doc, body.data(), body.size()) != DeserializationError::Ok) {
+        request->send(400, "text/plain", "JSON invalide");
+        return;
+    }
+
+    // Les jours du mois "month" sont recopiés cycliquement sur "from".."to"
+    int month = doc["month"] | -1;
+    int firstDay = doc["from"] | -1;
+    int lastDay = doc["to"] | -1;
+    if (month < 0 || month > 11 ||
+        firstDay < 0 || firstDay >= SeasonalConstants::DAYS || lastDay < 0 || lastDay >= SeasonalConstants::DAYS) {
+        request->send(400, "text/plain", "Paramètres 'month', 'from' et 'to' invalides");
+        return;
+    }
+    int sourceFirst, sourceLast;
+    SeasonalKernels::monthRange(month, sourceFirst, sourceLast);
+
+    SystemConfig& config = getGlobalConfig();
+    sendJobAccepted(request, SeasonalJobs::extend(config.currentProfileName, sourceFirst, sourceLast, firstDay, lastDay));
 }
 
 void AppWebServerManager::handleSmoothMonthData(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total) {
-    request->send(501, "text/plain", "Not Implemented");
+    RequestBody body;
+    if (!RequestBody::collect(request, data, len, index, total, body)) return;
+    StaticJsonDocument<256> doc;
+    if (deserializeJson(doc, body.data(), body.size()) != DeserializationError::Ok) {
+        request->send(400, "text/plain", "JSON invalide");
+        return;
+    }
+
+    SeasonalKernels::SmoothParams params;
+    int firstDay, lastDay;
+    const char* kernel = doc["kernel"] | "gaussian";
+    int dayRadius = doc["days"] | 3;
+    int hourRadius = doc["hours"] | 1;
+    if (!readDayRange(doc.as<JsonObjectConst>(), firstDay, lastDay) ||
+        (strcmp(kernel, "gaussian") != 0 && strcmp(kernel, "box") != 0) ||
+        dayRadius < 0 || dayRadius > SeasonalKernels::MAX_DAY_RADIUS ||
+        hourRadius < 0 || hourRadius > SeasonalKernels::MAX_HOUR_RADIUS) {
+        request->send(400, "text/plain", "Paramètres de lissage invalides");
+        return;
+    }
+    params.kernel = strcmp(kernel, "box") == 0 ? SeasonalKernels::KERNEL_BOX : SeasonalKernels::KERNEL_GAUSSIAN;
+    params.dayRadius = dayRadius;
+    params.hourRadius = hourRadius;
+    params.firstDay = firstDay;
+    params.lastDay = lastDay;
+
+    SystemConfig& config = getGlobalConfig();
+    sendJobAccepted(request, SeasonalJobs::smooth(config.currentProfileName, params));
 }
 
 void AppWebServerManager::handleApplyYearlyCurve(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total) {
+    RequestBody body;
+    if (!RequestBody::collect(request, data, len, index, total, body)) return;
     DynamicJsonDocument doc(1024);
-    if (deserializeJson(doc, data, len) != DeserializationError::Ok) {
+    if (deserializeJson(doc, body.data(), body.size()) != DeserializationError::Ok) {
         request->send(400, "text/plain", "JSON invalide");
         return;
     }
@@ -377,107 +674,372 @@ void AppWebServerManager::handleApplyYearlyCurve(AsyncWebServerRequest *request,
         return;
     }
 
-    float tempCurveFloat[24];
-    for (int i = 0; i < 24; i++) {
-        tempCurveFloat[i] = tempCurveJson[i].as<float>();
-    }
-
-    SystemConfig& config = getGlobalConfig();
-    bool success = true;
     // Convertir les floats en int16_t * 10 avant de sauvegarder
     int16_t tempCurveInt[24];
     for (int i = 0; i < 24; i++) {
-        tempCurveInt[i] = (int16_t)(tempCurveFloat[i] * 10);
+        tempCurveInt[i] = (int16_t)(tempCurveJson[i].as<float>() * 10);
     }
 
-    for (int day = 0; day < 366; day++) {
-        if (!ConfigManager::saveSeasonalData(config.currentProfileName, day, tempCurveInt)) {
-            success = false;
-            LOG_ERROR("WEBSERVER", "Failed to save seasonal data for day %d", day);
-            break;
-        }
-    }
+    // Réécriture de l'année en tâche de fond
+    SystemConfig& config = getGlobalConfig();
+    sendJobAccepted(request, SeasonalJobs::applyCurve(config.currentProfileName, tempCurveInt));
+}
 
-    if (success) {
-        request->send(200, "text/plain", "Courbe appliquée à toute l'année");
-    } else {
-        request->send(500, "text/plain", "Échec de l'application de la courbe");
+void AppWebServerManager::handleJobStatus(AsyncWebServerRequest *request) {
+    uint32_t job = request->hasParam("id") ? request->getParam("id")->value().toInt() : 0;
+    SeasonalJobs::State state = SeasonalJobs::getState(job);
+    if (state == SeasonalJobs::JOB_UNKNOWN) {
+        request->send(404, "text/plain", "Travail inconnu");
+        return;
     }
+    char buffer[48];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginObject()
+        .field("job", (unsigned long)job)
+        .field("state", SeasonalJobs::stateName(state))
+        .endObject();
+    sendJson(request, json);
 }
 
 void AppWebServerManager::handleStatus(AsyncWebServerRequest *request) {
     SystemConfig& config = getGlobalConfig();
-    DynamicJsonDocument doc(1024); // Increased size to accommodate more fields
+    char buffer[1024];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginObject();
+
+    // Instantané du dernier cycle de régulation : copie sans verrou,
+    // toutes les valeurs ci-dessous proviennent du même cycle.
+    SystemSnapshot snapshot = getSystemSnapshot();
+    json.field("snapshotVersion", snapshot.version);
 
     // Temperature and Humidity
-    doc["temperature"] = SensorManager::getCurrentTemperature();
-    doc["humidity"] = SensorManager::getCurrentHumidity();
+    json.field("temperature", snapshot.temperature);
+    json.field("humidity", snapshot.humidity);
+    json.field("sensorValid", snapshot.sensorValid);
+    json.field("sensorAgeMs", snapshot.sensorSequence ? millis() - snapshot.sensorTimestampMs : 0);
 
     // Heater State and Mode
-    doc["heaterState"] = getHeaterOutput() > 0 ? "ON" : "OFF"; // Derived from heater_output
-    doc["currentMode"] = config.usePWM ? "PID" : "Hysteresis"; // Derived from config.usePWM
-    doc["consigneTemp"] = getCurrentTargetTemperature(); // Renamed from "target"
+    json.field("heaterState", snapshot.heaterOutput > 0 ? "ON" : "OFF"); // Derived from heater_output
+    json.field("currentMode", snapshot.usePWM ? "PID" : "Hysteresis"); // Derived from config.usePWM
+    json.field("consigneTemp", snapshot.targetTemperature); // Renamed from "target"
 
     // PID/Hysteresis parameters (for modeDetails)
-    doc["Kp"] = config.Kp;
-    doc["Ki"] = config.Ki;
-    doc["Kd"] = config.Kd;
-    doc["hysteresis"] = config.hysteresis;
+    json.field("Kp", snapshot.Kp);
+    json.field("Ki", snapshot.Ki);
+    json.field("Kd", snapshot.Kd);
+    json.field("hysteresis", snapshot.hysteresis);
 
     // LED State
-    doc["ledState"] = config.ledState;
-    doc["ledRed"] = config.ledRed;
-    doc["ledGreen"] = config.ledGreen;
-    doc["ledBlue"] = config.ledBlue;
+    json.field("ledState", config.ledState);
+    json.field("ledRed", config.ledRed);
+    json.field("ledGreen", config.ledGreen);
+    json.field("ledBlue", config.ledBlue);
 
     // System Status (WiFi, Time)
-    doc["wifiConnected"] = WiFi.isConnected(); // Add WiFi status
+    json.field("wifiConnected", WiFi.isConnected()); // Add WiFi status
     struct tm timeinfo;
     if (getLocalTime(&timeinfo)) {
-        doc["currentTime"] = mktime(&timeinfo); // Unix timestamp
+        json.field("currentTime", (long)mktime(&timeinfo)); // Unix timestamp
     } else {
-        doc["currentTime"] = 0; // Default to 0 if time not available
+        json.field("currentTime", 0); // Default to 0 if time not available
     }
 
     // Other existing fields
-    doc["safety_level"] = SafetySystem::getCurrentLevel();
-    doc["safety_message"] = ""; // Still empty, as before
+    json.field("safety_level", (int)snapshot.safetyLevel);
+    json.field("safety_message", snapshot.safetyMessage);
 
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    // Cadencement de la boucle de régulation (microsecondes)
+    ControlTimingStats timing = ControlTask::getStats();
+    json.beginObject("controlLoop");
+    json.field("periodUs", timing.periodUs);
+    json.field("cycles", timing.cycles);
+    json.field("missedTicks", timing.missedTicks);
+    json.field("lastJitterUs", timing.lastJitterUs);
+    json.field("meanJitterUs", timing.meanJitterUs);
+    json.field("maxJitterUs", timing.maxJitterUs);
+    json.field("lastExecUs", timing.lastExecUs);
+    json.field("maxExecUs", timing.maxExecUs);
+    json.endObject();
+
+    json.endObject();
+    sendJson(request, json);
 }
 
+// Format binaire de /api/history.bin (petit-boutiste) : un en-tête suivi
+// de 'count' HistoryWireRecord, count = (taille - en-tête) / recordSize.
+struct __attribute__((packed)) HistoryWireHeader {
+    uint32_t magic;           // HISTORY_WIRE_MAGIC ("HHB1")
+    uint16_t version;
+    uint16_t recordSize;      // sizeof(HistoryWireRecord)
+    uint32_t from;            // Fenêtre demandée (heure Unix)
+    uint32_t to;
+};
+
+struct __attribute__((packed)) HistoryWireRecord {
+    uint32_t time;            // Heure Unix
+    int16_t temperature;      // En int16_t
+    uint8_t humidity;         // % (HISTORY_UNKNOWN_HUMIDITY = inconnue)
+    uint8_t heaterDuty;       // Sortie chauffage 0-255
+};
+
+static const uint32_t HISTORY_WIRE_MAGIC = 0x31424848;
+static const uint16_t HISTORY_WIRE_VERSION = 1;
+
+// Curseur d'une réponse /api/history(.bin) : la réponse est produite par
+// morceaux, directement depuis l'anneau vers le tampon TCP, sans copie
+// intermédiaire.
+struct HistoryCursor {
+    uint32_t index;           // Prochain index HistoryLog à examiner
+    uint32_t from;            // Premier horodatage inclus
+    uint32_t to;              // Dernier horodatage inclus
+    uint32_t step;            // Écart minimal entre deux points renvoyés (s)
+    uint32_t remaining;       // Points encore autorisés par 'limit'
+    bool binary;
+    uint32_t nextTime;        // Premier horodatage acceptable
+    bool started;
+    bool empty;               // Aucun point écrit (pas de virgule)
+    bool finished;
+
+    HistoryCursor(uint32_t from, uint32_t to, uint32_t step, uint32_t limit, bool binary)
+        : index(HistoryLog::findFirst(from)), from(from), to(to), step(step), remaining(limit),
+          binary(binary), nextTime(from), started(false), empty(true), finished(false) {}
+
+    size_t fill(uint8_t* buffer, size_t maxLen) {
+        // Un point JSON fait au plus ~70 octets ; plus de quoi fermer le tableau
+        const size_t recordMax = binary ? sizeof(HistoryWireHeader) : 80;
+        size_t len = 0;
+        if (!started) {
+            if (maxLen < recordMax) return RESPONSE_TRY_AGAIN;
+            if (binary) {
+                HistoryWireHeader header = { HISTORY_WIRE_MAGIC, HISTORY_WIRE_VERSION,
+                                             sizeof(HistoryWireRecord), from, to };
+                memcpy(buffer, &header, sizeof(header));
+                len = sizeof(header);
+            } else {
+                buffer[len++] = '[';
+            }
+            started = true;
+        }
+        HistoryEntry entry;
+        uint32_t head = HistoryLog::getHead();
+        while (!finished && maxLen - len >= recordMax) {
+            if (index >= head || remaining == 0) {
+                if (!binary) buffer[len++] = ']';
+                finished = true;
+                break;
+            }
+            // Écrasé pendant la réponse : reprend au plus ancien
+            index = max(index, HistoryLog::getOldest());
+            if (!HistoryLog::read(index++, entry) || entry.timestamp < nextTime) continue;
+            if (entry.timestamp > to) {
+                index = head;
+                continue;
+            }
+            len += binary ? writeBinary(buffer + len, entry) : writeJson((char*)buffer + len, maxLen - len, entry);
+            nextTime = entry.timestamp + max(step, 1u);
+            remaining--;
+            empty = false;
+        }
+        // Fenêtre TCP trop petite pour un point : 0 terminerait la réponse
+        if (len == 0 && !finished) return RESPONSE_TRY_AGAIN;
+        return len;
+    }
+
+    size_t writeBinary(uint8_t* out, const HistoryEntry& entry) {
+        HistoryWireRecord record = { entry.timestamp, entry.temperature,
+                                     isnan(entry.humidity) ? HISTORY_UNKNOWN_HUMIDITY : (uint8_t)entry.humidity,
+                                     entry.heaterDuty };
+        memcpy(out, &record, sizeof(record));
+        return sizeof(record);
+    }
+
+    size_t writeJson(char* out, size_t maxLen, const HistoryEntry& entry) {
+        char humidity[8];
+        if (isnan(entry.humidity)) {
+            strcpy(humidity, "null");
+        } else {
+            snprintf(humidity, sizeof(humidity), "%u", (unsigned)entry.humidity);
+        }
+        return snprintf(out, maxLen, "%s{\"time\":%lu,\"temp\":%d,\"hum\":%s,\"duty\":%u}",
+                        empty ? "" : ",", (unsigned long)entry.timestamp, entry.temperature, humidity, entry.heaterDuty);
+    }
+};
+
 void AppWebServerManager::handleHistory(AsyncWebServerRequest *request) {
-    DynamicJsonDocument doc(8192);
-    JsonArray arr = doc.to<JsonArray>();
-    HistoryRecord* history = getHistory();
-    int startIndex = getHistoryIndex();
-    bool full = isHistoryFull();
+    sendHistory(request, false);
+}
 
-    int count = full ? MAX_HISTORY_RECORDS : startIndex;
+void AppWebServerManager::handleHistoryBinary(AsyncWebServerRequest *request) {
+    sendHistory(request, true);
+}
 
-    for (int i = 0; i < count; i++) {
-        int index = (startIndex - 1 - i + MAX_HISTORY_RECORDS) % MAX_HISTORY_RECORDS;
-        if (!full && index >= startIndex) continue;
+void AppWebServerManager::sendHistory(AsyncWebServerRequest *request, bool binary) {
+    uint32_t head = HistoryLog::getHead();
+    HistoryEntry last;
+    uint32_t latest = head > 0 && HistoryLog::read(head - 1, last) ? last.timestamp : (uint32_t)time(nullptr);
 
-        JsonObject record = arr.createNestedObject();
-        record["time"] = history[index].timestamp;
-        record["temp"] = history[index].temperature;
-        record["hum"] = history[index].humidity;
+    // Par défaut : les dernières 24 h, à pleine résolution
+    uint32_t to = request->hasParam("to") ? (uint32_t)request->getParam("to")->value().toInt() : latest;
+    uint32_t from = to > 86400 ? to - 86400 : 0;
+    if (request->hasParam("from")) {
+        from = (uint32_t)request->getParam("from")->value().toInt();
+    }
+    uint32_t limit = MAX_HISTORY_RECORDS;
+    if (request->hasParam("limit")) {
+        limit = (uint32_t)constrain(request->getParam("limit")->value().toInt(), 1L, (long)HistoryLog::getCapacity());
+    }
+    uint32_t step = 0;
+    if (request->hasParam("step")) {
+        step = (uint32_t)max(0L, request->getParam("step")->value().toInt());
+    }
+    if (from > to) {
+        request->send(400, "text/plain", "Intervalle invalide (from > to)");
+        return;
     }
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+
+    HistoryCursor cursor(from, to, step, limit, binary);
+    AsyncWebServerResponse *response = request->beginChunkedResponse(
+        binary ? "application/octet-stream" : "application/json",
+        [cursor](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+            return cursor.fill(buffer, maxLen);
+        });
+    request->send(response);
+}
+
+void AppWebServerManager::handleHistoryRollup(AsyncWebServerRequest *request) {
+    RollupResolution resolution = ROLLUP_DAY;
+    if (request->hasParam("res")) {
+        String res = request->getParam("res")->value();
+        if (res == "hour") {
+            resolution = ROLLUP_HOUR;
+        } else if (res != "day") {
+            request->send(400, "text/plain", "Résolution invalide (hour ou day)");
+            return;
+        }
+    }
+    uint32_t limit = resolution == ROLLUP_DAY ? 365 : 168;
+    if (request->hasParam("limit")) {
+        limit = (uint32_t)max(1L, request->getParam("limit")->value().toInt());
+    }
+
+    // Les 'limit' périodes les plus récentes, de la plus ancienne à la plus récente
+    uint32_t head = HistoryRollup::getHead(resolution);
+    uint32_t oldest = HistoryRollup::getOldest(resolution);
+    uint32_t first = head - min(limit, head - oldest);
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->print('[');
+    bool firstRecord = true;
+    RollupBucket bucket;
+    for (uint32_t index = first; index < head; index++) {
+        if (!HistoryRollup::read(resolution, index, bucket)) continue;
+        response->printf("%s{\"t\":%lu,\"n\":%u,\"tmin\":%d,\"tavg\":%d,\"tmax\":%d,",
+                         firstRecord ? "" : ",", (unsigned long)bucket.start, bucket.samples,
+                         bucket.tempMin, bucket.tempMean(), bucket.tempMax);
+        if (bucket.humSamples > 0) {
+            response->printf("\"hmin\":%u,\"havg\":%.1f,\"hmax\":%u,", bucket.humMin, bucket.humMean(), bucket.humMax);
+        } else {
+            response->print("\"hmin\":null,\"havg\":null,\"hmax\":null,");
+        }
+        response->printf("\"on\":%lu}", (unsigned long)bucket.heaterOnSeconds);
+        firstRecord = false;
+    }
+    response->print(']');
+    request->send(response);
+}
+
+size_t AppWebServerManager::formatStatusEvent(char* out, size_t size, const SystemSnapshot& snapshot,
+                                              const SystemSnapshot* previous) {
+    // Mêmes noms de champs que /api/status ; seuls les champs modifiés
+    // depuis 'previous' sont écrits (tous si previous est nul).
+    JsonWriter json(out, size);
+    json.beginObject();
+    json.field("snapshotVersion", snapshot.version);
+    if (!previous || snapshot.temperature != previous->temperature) {
+        json.field("temperature", snapshot.temperature);
+    }
+    if (!previous || !(snapshot.humidity == previous->humidity)) {
+        json.field("humidity", snapshot.humidity);
+    }
+    if (!previous || snapshot.sensorValid != previous->sensorValid) {
+        json.field("sensorValid", snapshot.sensorValid);
+    }
+    if (!previous || (snapshot.heaterOutput > 0) != (previous->heaterOutput > 0)) {
+        json.field("heaterState", snapshot.heaterOutput > 0 ? "ON" : "OFF");
+    }
+    if (!previous || snapshot.heaterOutput != previous->heaterOutput) {
+        json.field("heaterOutput", (int)snapshot.heaterOutput);
+    }
+    if (!previous || snapshot.usePWM != previous->usePWM) {
+        json.field("currentMode", snapshot.usePWM ? "PID" : "Hysteresis");
+    }
+    if (!previous || snapshot.targetTemperature != previous->targetTemperature) {
+        json.field("consigneTemp", snapshot.targetTemperature);
+    }
+    if (!previous || snapshot.Kp != previous->Kp || snapshot.Ki != previous->Ki || snapshot.Kd != previous->Kd) {
+        json.field("Kp", snapshot.Kp).field("Ki", snapshot.Ki).field("Kd", snapshot.Kd);
+    }
+    if (!previous || snapshot.hysteresis != previous->hysteresis) {
+        json.field("hysteresis", snapshot.hysteresis);
+    }
+    if (!previous || snapshot.safetyLevel != previous->safetyLevel ||
+        strcmp(snapshot.safetyMessage, previous->safetyMessage) != 0) {
+        json.field("safety_level", (int)snapshot.safetyLevel).field("safety_message", snapshot.safetyMessage);
+    }
+    json.field("currentTime", (unsigned long)time(nullptr));
+    json.endObject();
+    return json.length();
+}
+
+void AppWebServerManager::pushStatusEvents() {
+    static SystemSnapshot lastSent;
+    static SystemSnapshot lastSafety;     // Dernier état de sécurité envoyé
+    static unsigned long lastFullStatus = 0;
+
+    SystemSnapshot snapshot = getSystemSnapshot();
+    if (snapshot.version == lastSent.version) return;
+    if (events.count() == 0) {
+        lastSent = snapshot;
+        lastSafety = snapshot;
+        return;
+    }
+
+    // La sécurité passe toujours, même derrière un client lent
+    char message[512];
+    if (snapshot.safetyLevel != lastSafety.safetyLevel || snapshot.emergencyShutdown != lastSafety.emergencyShutdown ||
+        strcmp(snapshot.safetyMessage, lastSafety.safetyMessage) != 0) {
+        JsonWriter json(message, sizeof(message));
+        json.beginObject()
+            .field("level", (int)snapshot.safetyLevel)
+            .field("message", snapshot.safetyMessage)
+            .field("emergencyShutdown", snapshot.emergencyShutdown)
+            .endObject();
+        events.send(message, "safety", snapshot.version);
+        lastSafety = snapshot;
+    }
+
+    // Client lent : on attend, le prochain delta couvrira tous les changements
+    if (events.avgPacketsWaiting() > WebConstants::EVENT_MAX_QUEUED) return;
+
+    // Un statut complet de temps en temps rattrape un delta perdu
+    unsigned long now = millis();
+    bool full = now - lastFullStatus >= WebConstants::EVENT_FULL_STATUS_MS;
+    if (full) lastFullStatus = now;
+    formatStatusEvent(message, sizeof(message), snapshot, full ? nullptr : &lastSent);
+    events.send(message, "status", snapshot.version);
+    lastSent = snapshot;
 }
 
 void AppWebServerManager::handleSafetyStatus(AsyncWebServerRequest *request) {
-    DynamicJsonDocument doc(256);
-    doc["level"] = SafetySystem::getCurrentLevel();
-    doc["message"] = "";
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    SystemSnapshot snapshot = getSystemSnapshot();
+    char buffer[192];
+    JsonWriter json(buffer, sizeof(buffer));
+    json.beginObject()
+        .field("level", (int)snapshot.safetyLevel)
+        .field("message", snapshot.safetyMessage)
+        .field("emergencyShutdown", snapshot.emergencyShutdown)
+        .endObject();
+    sendJson(request, json);
 }
 
 
@@ -517,15 +1079,98 @@ void AppWebServerManager::handleDownloadSeasonalData(AsyncWebServerRequest *requ
 }
 
 void AppWebServerManager::handleSetCamera(AsyncWebServerRequest *request) {
+    if (!request->hasParam("enabled") && !request->hasParam("fps")) {
+        request->send(400, "text/plain", "Missing 'enabled' or 'fps' parameter");
+        return;
+    }
+    // Tout est validé avant d'appliquer quoi que ce soit
+    int fps = 0;
+    if (request->hasParam("fps")) {
+        fps = request->getParam("fps")->value().toInt();
+        if (fps < 1 || fps > CameraConstants::MAX_TARGET_FPS) {
+            request->send(400, "text/plain", "'fps' must be between 1 and " + String(CameraConstants::MAX_TARGET_FPS));
+            return;
+        }
+    }
     if (request->hasParam("enabled")) {
         bool enabled = request->getParam("enabled")->value() == "1";
         getGlobalConfig().cameraEnabled = enabled;
         LOG_INFO("WEBSERVER", "Camera state set to: %s", enabled ? "ON" : "OFF");
-        request->send(200, "text/plain", "OK");
     }
-    else {
-        request->send(400, "text/plain", "Missing 'enabled' parameter");
+    if (fps > 0) CameraManager::setFramerate(fps);
+    request->send(200, "text/plain", "OK");
+}
+
+void AppWebServerManager::handleMJPEGInfo(AsyncWebServerRequest *request) {
+    if (!CameraManager::initialized) {
+        request->send(503, "text/plain", "Caméra non initialisée");
+        return;
+    }
+    StreamAdaptation state = CameraManager::getStreamAdaptation();
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"stream_url\":\"/mjpeg\",\"clients\":%d,\"adaptive\":%s,\"resolution\":\"%s\","
+                     "\"width\":%u,\"height\":%u,\"quality\":%u,\"level\":%u,\"levels\":%u,\"targetFps\":%u,"
+                     "\"captureFps\":%u.%u,\"achievedFps\":%u.%u,\"sendMs\":%u,\"backlogFrames\":%u}",
+                     state.clients, state.adaptive ? "true" : "false", state.resolution,
+                     state.width, state.height, state.quality, state.level, state.levels, state.targetFps,
+                     state.captureFps10 / 10, state.captureFps10 % 10, state.achievedFps10 / 10, state.achievedFps10 % 10,
+                     state.sendMs, state.backlogFrames);
+    request->send(response);
+}
+
+void AppWebServerManager::handleCameraEvents(AsyncWebServerRequest *request) {
+    // Copie de l'index : la tâche de détection peut en supprimer pendant l'envoi
+    MotionEvent* list = new MotionEvent[MotionConstants::MAX_EVENTS];
+    size_t count = MotionRecorder::getEvents(list, MotionConstants::MAX_EVENTS);
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"enabled\":%s,\"bytes\":%lu,\"maxBytes\":%lu,\"cpu\":%u,\"events\":[",
+                     getGlobalConfig().motionRecording ? "true" : "false",
+                     (unsigned long)MotionRecorder::getStoredBytes(), (unsigned long)MotionConstants::MAX_BYTES,
+                     MotionRecorder::getCpuPermille());
+    for (size_t i = 0; i < count; i++) {
+        const MotionEvent& event = list[i];
+        response->printf("%s{\"id\":%lu,\"time\":%lu,\"frames\":%u,\"score\":%u,\"bytes\":%lu}",
+                         i == 0 ? "" : ",", (unsigned long)event.id, (unsigned long)event.time,
+                         event.frames, event.score, (unsigned long)event.bytes);
+    }
+    response->print("]}");
+    delete[] list;
+    request->send(response);
+}
+
+void AppWebServerManager::handleCameraEventFrame(AsyncWebServerRequest *request) {
+    if (!request->hasParam("id")) {
+        request->send(400, "text/plain", "Paramètre 'id' manquant");
+        return;
+    }
+    uint32_t id = (uint32_t)request->getParam("id")->value().toInt();
+    uint16_t frame = request->hasParam("n") ? (uint16_t)request->getParam("n")->value().toInt() : 0;
+    String path = MotionRecorder::framePath(id, frame);
+    if (!LittleFS.exists(path)) {
+        request->send(404, "text/plain", "Image introuvable");
+        return;
+    }
+    AsyncWebServerResponse *response = request->beginResponse(LittleFS, path, "image/jpeg");
+    response->addHeader("Cache-Control", "max-age=86400");   // Une image d'événement ne change jamais
+    request->send(response);
+}
+
+void AppWebServerManager::handleTimelapse(AsyncWebServerRequest *request) {
+    TimelapseDay* list = new TimelapseDay[TimelapseConstants::MAX_DAYS];
+    size_t count = Timelapse::getDays(list, TimelapseConstants::MAX_DAYS);
+
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"minutes\":%u,\"bytes\":%lu,\"maxBytes\":%lu,\"dropped\":%lu,\"days\":[",
+                     getGlobalConfig().timelapseMinutes, (unsigned long)Timelapse::getStoredBytes(),
+                     (unsigned long)TimelapseConstants::MAX_BYTES, (unsigned long)Timelapse::getDroppedFrames());
+    for (size_t i = 0; i < count; i++) {
+        response->printf("%s{\"date\":%lu,\"frames\":%u,\"bytes\":%lu}", i == 0 ? "" : ",",
+                         (unsigned long)list[i].date, list[i].frames, (unsigned long)list[i].bytes);
     }
+    response->print("]}");
+    delete[] list;
+    request->send(response);
 }
 
 bool AppWebServerManager::validateJsonConfig(const DynamicJsonDocument& doc) {
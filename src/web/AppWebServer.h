@@ -5,14 +5,25 @@
 #include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
 
+struct SystemSnapshot;
+
 class AppWebServerManager {
 public:
     static void setupRoutes(AsyncWebServer& server);
 
+    /**
+     * @brief Pousse aux clients de /api/events ce qui a changé depuis le
+     * dernier instantané envoyé. À appeler régulièrement depuis la tâche
+     * principale (jamais depuis la tâche de régulation).
+     */
+    static void pushStatusEvents();
+
 private:
     // Handlers
+    static void handleStaticAsset(AsyncWebServerRequest *request);
     static void handleGetCurrentConfig(AsyncWebServerRequest *request);
     static void handleApplyAllSettings(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total);
+    static void handlePatchConfig(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total);
     static void handleSaveConfiguration(AsyncWebServerRequest *request);
     static void handleListProfiles(AsyncWebServerRequest *request);
     static void handleLoadProfile(AsyncWebServerRequest *request);
@@ -22,11 +33,15 @@ private:
     static void handleGetDayData(AsyncWebServerRequest *request);
     static void handleSaveDayData(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total);
     static void handleGetYearlyTemperatures(AsyncWebServerRequest *request);
+    static void handleUploadSeasonalData(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total);
     static void handleExtendMonthData(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total);
     static void handleSmoothMonthData(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total);
     static void handleApplyYearlyCurve(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total);
+    static void handleJobStatus(AsyncWebServerRequest *request);
     static void handleStatus(AsyncWebServerRequest *request);
     static void handleHistory(AsyncWebServerRequest *request);
+    static void handleHistoryBinary(AsyncWebServerRequest *request);
+    static void handleHistoryRollup(AsyncWebServerRequest *request);
     static void handleSafetyStatus(AsyncWebServerRequest *request);
     static void handleCapture(AsyncWebServerRequest *request);
     static void handleMJPEG(AsyncWebServerRequest *request);
@@ -34,9 +49,19 @@ private:
     static void handleDownloadProfile(AsyncWebServerRequest *request);
     static void handleDownloadSeasonalData(AsyncWebServerRequest *request);
     static void handleSetCamera(AsyncWebServerRequest *request);
+    static void handleCameraEvents(AsyncWebServerRequest *request);
+    static void handleCameraEventFrame(AsyncWebServerRequest *request);
+    static void handleTimelapse(AsyncWebServerRequest *request);
 
     // Validation
     static bool validateJsonConfig(const DynamicJsonDocument& doc);
+
+    // Historique JSON ou binaire (fenêtre from/to/limit/step)
+    static void sendHistory(AsyncWebServerRequest *request, bool binary);
+
+    // Canal Server-Sent Events du statut
+    static AsyncEventSource events;
+    static size_t formatStatusEvent(char* out, size_t size, const SystemSnapshot& snapshot, const SystemSnapshot* previous);
 };
 
 #endif // APPWEBSERVER_H
\ No newline at end of file
@@ -0,0 +1,158 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <Arduino.h>
+#include <cmath>
+
+// Écrivain JSON en flux dans un tampon fourni par l'appelant (en général sur
+// la pile du gestionnaire web) : aucune allocation, aucune copie
+// intermédiaire. Les virgules sont placées automatiquement à chaque niveau
+// d'imbrication (32 au plus). Si le tampon est trop petit, le texte est
+// tronqué et overflow() renvoie true : l'appelant répond alors par une erreur.
+//
+//   char buffer[256];
+//   JsonWriter json(buffer, sizeof(buffer));
+//   json.beginObject().field("temp", 235).field("ok", true).endObject();
+class JsonWriter {
+public:
+    JsonWriter(char* buffer, size_t size) : out(buffer), capacity(size) {
+        if (capacity > 0) out[0] = '\0';
+    }
+
+    // === STRUCTURE ===
+    JsonWriter& beginObject() { return open('{'); }
+    JsonWriter& beginObject(const char* name) { key(name); return open('{'); }
+    JsonWriter& endObject() { return close('}'); }
+    JsonWriter& beginArray() { return open('['); }
+    JsonWriter& beginArray(const char* name) { key(name); return open('['); }
+    JsonWriter& endArray() { return close(']'); }
+
+    /**
+     * @brief Écrit une clé d'objet ; la valeur suit par value() ou begin*().
+     */
+    JsonWriter& key(const char* name) {
+        separator();
+        string(name);
+        put(':');
+        pendingValue = true;
+        return *this;
+    }
+
+    // === VALEURS ===
+    JsonWriter& value(bool v) { separator(); return raw(v ? "true" : "false"); }
+    JsonWriter& value(int v) { separator(); return print("%d", v); }
+    JsonWriter& value(unsigned int v) { separator(); return print("%u", v); }
+    JsonWriter& value(long v) { separator(); return print("%ld", v); }
+    JsonWriter& value(unsigned long v) { separator(); return print("%lu", v); }
+    JsonWriter& value(long long v) { separator(); return print("%lld", v); }
+    JsonWriter& value(unsigned long long v) { separator(); return print("%llu", v); }
+    JsonWriter& value(double v) {
+        // NaN et infini n'existent pas en JSON
+        separator();
+        return std::isfinite(v) ? print("%.7g", v) : raw("null");
+    }
+    JsonWriter& value(const char* v) { separator(); string(v); return *this; }
+    JsonWriter& value(const String& v) { return value(v.c_str()); }
+    JsonWriter& null() { separator(); return raw("null"); }
+
+    /**
+     * @brief Écrit une paire clé/valeur.
+     */
+    template <typename T>
+    JsonWriter& field(const char* name, const T& v) {
+        key(name);
+        return value(v);
+    }
+
+    // === RÉSULTAT ===
+    const char* c_str() const { return out; }
+    size_t length() const { return len; }
+    bool overflow() const { return truncated; }
+
+private:
+    char* out;
+    size_t capacity;
+    size_t len = 0;
+    uint32_t hasItems = 0;        // Bit n : le niveau n contient déjà un élément
+    uint8_t depth = 0;
+    bool pendingValue = false;    // Une clé attend sa valeur (pas de virgule)
+    bool truncated = false;
+
+    void put(char c) {
+        if (len + 1 < capacity) {
+            out[len++] = c;
+            out[len] = '\0';
+        } else {
+            truncated = true;
+        }
+    }
+
+    JsonWriter& raw(const char* text) {
+        while (*text) put(*text++);
+        return *this;
+    }
+
+    JsonWriter& print(const char* format, ...) {
+        if (len >= capacity) {
+            truncated = true;
+            return *this;
+        }
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(out + len, capacity - len, format, args);
+        va_end(args);
+        if (written < 0 || (size_t)written >= capacity - len) {
+            truncated = true;
+            len = capacity - 1;
+        } else {
+            len += written;
+        }
+        return *this;
+    }
+
+    void string(const char* text) {
+        put('"');
+        for (; text && *text; text++) {
+            unsigned char c = (unsigned char)*text;
+            if (c == '"' || c == '\\') {
+                put('\\');
+                put((char)c);
+            } else if (c == '\n') {
+                raw("\\n");
+            } else if (c < 0x20) {
+                print("\\u%04x", c);
+            } else {
+                put((char)c);  // UTF-8 transmis tel quel
+            }
+        }
+        put('"');
+    }
+
+    void separator() {
+        if (pendingValue) {
+            pendingValue = false;
+            return;
+        }
+        if (depth > 0 && depth <= 32) {
+            uint32_t bit = 1UL << (depth - 1);
+            if (hasItems & bit) put(',');
+            hasItems |= bit;
+        }
+    }
+
+    JsonWriter& open(char c) {
+        separator();
+        put(c);
+        depth++;
+        if (depth <= 32) hasItems &= ~(1UL << (depth - 1));
+        return *this;
+    }
+
+    JsonWriter& close(char c) {
+        if (depth > 0) depth--;
+        put(c);
+        return *this;
+    }
+};
+
+#endif // JSON_WRITER_H
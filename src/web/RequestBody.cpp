@@ -0,0 +1,47 @@
+#include "RequestBody.h"
+#include "../utils/Logger.h"
+
+bool RequestBody::collect(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total,
+                          RequestBody& body, size_t maxSize) {
+    // Cas courant : le corps tient dans un seul segment, lu sur place
+    if (index == 0 && len == total) {
+        body.buffer = data;
+        body.length = total;
+        body.position = 0;
+        return true;
+    }
+
+    if (index == 0) {
+        if (total > maxSize) {
+            LOG_WARN("WEB", "Corps de %u octets refusé pour %s", (unsigned)total, request->url().c_str());
+            request->send(413, "text/plain", "Requête trop volumineuse");
+            return false;
+        }
+        uint8_t* assembled = (uint8_t*)ps_malloc(total);
+        if (!assembled) assembled = (uint8_t*)malloc(total);
+        if (!assembled) {
+            LOG_ERROR("WEB", "Mémoire insuffisante pour un corps de %u octets", (unsigned)total);
+            request->send(500, "text/plain", "Mémoire insuffisante");
+            return false;
+        }
+        request->_tempObject = assembled;
+    }
+
+    // Pas de tampon : la requête a déjà été refusée au premier fragment
+    uint8_t* assembled = (uint8_t*)request->_tempObject;
+    if (!assembled || index + len > total) return false;
+    memcpy(assembled + index, data, len);
+    if (index + len < total) return false;
+
+    body.buffer = assembled;
+    body.length = total;
+    body.position = 0;
+    return true;
+}
+
+size_t RequestBody::readBytes(char* out, size_t count) {
+    size_t n = min(count, length - position);
+    memcpy(out, buffer + position, n);
+    position += n;
+    return n;
+}
@@ -0,0 +1,52 @@
+#ifndef REQUEST_BODY_H
+#define REQUEST_BODY_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "../config/SystemConfig.h"
+
+// Corps complet d'une requête POST, reçu par AsyncTCP en un ou plusieurs
+// fragments (un par segment TCP). Les fragments sont assemblés dans un tampon
+// de la taille annoncée (Content-Length), en PSRAM si possible, rattaché à la
+// requête (_tempObject) : la bibliothèque le libère avec la requête.
+//
+// Le corps se lit soit d'un bloc (data()/size()), soit comme un Stream pour
+// analyser un grand tableau JSON élément par élément :
+//
+//   RequestBody body;
+//   if (!RequestBody::collect(request, data, len, index, total, body)) return;
+//   deserializeJson(doc, body.data(), body.size());
+class RequestBody : public Stream {
+public:
+    // Tampon en mémoire : attendre ne ferait rien arriver de plus
+    RequestBody() { setTimeout(0); }
+
+    /**
+     * @brief Ajoute un fragment reçu au corps de la requête.
+     * @param body Rempli avec le corps complet au dernier fragment.
+     * @param maxSize Taille maximale acceptée ; au-delà, répond 413.
+     * @return true quand le corps est complet ; false s'il manque des
+     * fragments ou si la requête a déjà reçu une réponse d'erreur.
+     */
+    static bool collect(AsyncWebServerRequest *request, uint8_t* data, size_t len, size_t index, size_t total,
+                        RequestBody& body, size_t maxSize = WebConstants::MAX_BODY_BYTES);
+
+    const char* data() const { return (const char*)buffer; }
+    size_t size() const { return length; }
+    void rewind() { position = 0; }
+
+    // === LECTURE EN FLUX (Stream) ===
+    int available() override { return (int)(length - position); }
+    int read() override { return position < length ? buffer[position++] : -1; }
+    int peek() override { return position < length ? buffer[position] : -1; }
+    size_t readBytes(char* out, size_t count);
+    size_t write(uint8_t) override { return 0; }
+    void flush() override {}
+
+private:
+    const uint8_t* buffer = nullptr;
+    size_t length = 0;
+    size_t position = 0;
+};
+
+#endif // REQUEST_BODY_H
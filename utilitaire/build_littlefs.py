@@ -0,0 +1,167 @@
+"""
+Préparation de l'image LittleFS à partir de data/ :
+
+1. Regroupement du frontend : les modules ES de data/js (depuis js/main.js)
+   sont réunis et allégés (commentaires, indentation) en un seul fichier
+   /assets/app.<hash>.js ; css/style.css devient /assets/style.<hash>.css.
+   index.html est réécrit pour pointer vers ces fichiers. Leur nom change
+   avec leur contenu : le serveur les envoie avec un cache "immutable".
+2. Compression : chaque fichier web (html, css, js, ico, svg) est remplacé
+   par sa version .gz. Le serveur l'envoie avec Content-Encoding: gzip et un
+   ETag tiré de l'en-queue gzip (CRC-32 + taille du contenu non compressé).
+
+Les autres fichiers (profils, temperature.bin) sont copiés tels quels : le
+firmware les lit et les réécrit.
+
+Utilisation :
+  - automatique avec PlatformIO (extra_scripts = pre:utilitaire/build_littlefs.py)
+    pour les cibles buildfs et uploadfs ;
+  - manuelle : python utilitaire/build_littlefs.py data build/littlefs
+"""
+import gzip
+import hashlib
+import io
+import os
+import posixpath
+import re
+import shutil
+import sys
+
+COMPRESSED_EXTENSIONS = (".html", ".css", ".js", ".ico", ".svg")
+ENTRY_MODULE = "js/main.js"
+STYLESHEET = "css/style.css"
+ASSETS_DIR = "assets"
+
+IMPORT_RE = re.compile(r"^[ \t]*import\s*\{([^}]*)\}\s*from\s*['\"]([^'\"]+)['\"];?[ \t]*$", re.M)
+EXPORT_RE = re.compile(r"^export\s+((?:async\s+)?(?:function\s*\*?|const|let|class)\s*([A-Za-z_$][\w$]*))", re.M)
+
+
+def read_tree(source_dir):
+    files = {}
+    for root, _, names in os.walk(source_dir):
+        for name in names:
+            path = os.path.join(root, name)
+            files[os.path.relpath(path, source_dir).replace(os.sep, "/")] = open(path, "rb").read()
+    return files
+
+
+def strip_js(code):
+    # Allègement prudent : lignes de commentaire, blocs /* */ en début de
+    # ligne, indentation et lignes vides. Le reste (chaînes, expressions
+    # régulières) n'est pas touché ; gzip fait le reste.
+    lines = []
+    in_block = False
+    for line in code.splitlines():
+        stripped = line.strip()
+        if in_block:
+            in_block = "*/" not in stripped
+            continue
+        if stripped.startswith("/*"):
+            in_block = "*/" not in stripped
+            continue
+        if not stripped or stripped.startswith("//"):
+            continue
+        lines.append(stripped)
+    return "\n".join(lines)
+
+
+def bundle_modules(files):
+    """Réunit les modules ES atteignables depuis ENTRY_MODULE dans une IIFE."""
+    order, visiting = [], set()
+
+    def visit(module):
+        if module in order:
+            return
+        if module in visiting:
+            raise RuntimeError(f"Import circulaire : {module}")
+        if module not in files:
+            raise RuntimeError(f"Module introuvable : {module}")
+        visiting.add(module)
+        for _, target in IMPORT_RE.findall(files[module].decode("utf-8")):
+            visit(posixpath.normpath(posixpath.join(posixpath.dirname(module), target)))
+        visiting.discard(module)
+        order.append(module)
+
+    visit(ENTRY_MODULE)
+
+    out = ["(() => {", "const __modules = {};"]
+    for module in order:
+        code = files[module].decode("utf-8")
+        imports = []
+        for names, target in IMPORT_RE.findall(code):
+            resolved = posixpath.normpath(posixpath.join(posixpath.dirname(module), target))
+            bindings = ", ".join(n.strip().replace(" as ", ": ") for n in names.split(",") if n.strip())
+            imports.append(f"const {{ {bindings} }} = __modules['{resolved}'];")
+        code = IMPORT_RE.sub("", code)
+        exports = [name for _, name in EXPORT_RE.findall(code)]
+        code = EXPORT_RE.sub(r"\1", code)
+        out.append(f"__modules['{module}'] = (() => {{")
+        out.extend(imports)
+        out.append(strip_js(code))
+        out.append(f"return {{ {', '.join(exports)} }};")
+        out.append("})();")
+    out.append("})();")
+    return "\n".join(out).encode("utf-8"), order
+
+
+def hashed_name(stem, ext, content):
+    return f"{ASSETS_DIR}/{stem}.{hashlib.sha256(content).hexdigest()[:8]}{ext}"
+
+
+def bundle_frontend(files):
+    if ENTRY_MODULE not in files or "index.html" not in files:
+        return files
+    bundle, modules = bundle_modules(files)
+    bundle_path = hashed_name("app", ".js", bundle)
+    html = files["index.html"].decode("utf-8")
+    html = re.sub(r'<script\s+src="/' + re.escape(ENTRY_MODULE) + r'"[^>]*></script>',
+                  f'<script src="/{bundle_path}" type="module"></script>', html)
+
+    result = {path: data for path, data in files.items() if path not in modules}
+    result[bundle_path] = bundle
+    if STYLESHEET in files:
+        css_path = hashed_name("style", ".css", files[STYLESHEET])
+        html = html.replace(f'href="/{STYLESHEET}"', f'href="/{css_path}"')
+        result[css_path] = result.pop(STYLESHEET)
+    result["index.html"] = html.encode("utf-8")
+    print(f"Frontend : {len(modules)} modules -> /{bundle_path} ({len(bundle)} octets)")
+    return result
+
+
+def gzip_bytes(data):
+    # mtime=0 et pas de nom de fichier : même contenu => même archive
+    raw = io.BytesIO()
+    with gzip.GzipFile(filename="", mode="wb", compresslevel=9, fileobj=raw, mtime=0) as dst:
+        dst.write(data)
+    return raw.getvalue()
+
+
+def stage_data(source_dir, staging_dir):
+    files = bundle_frontend(read_tree(source_dir))
+    if os.path.isdir(staging_dir):
+        shutil.rmtree(staging_dir)
+    original = compressed = 0
+    for path, data in files.items():
+        if path.lower().endswith(COMPRESSED_EXTENSIONS):
+            original += len(data)
+            data = gzip_bytes(data)
+            compressed += len(data)
+            path += ".gz"
+        target = os.path.join(staging_dir, *path.split("/"))
+        os.makedirs(os.path.dirname(target), exist_ok=True)
+        with open(target, "wb") as f:
+            f.write(data)
+    print(f"Fichiers web compressés : {original} -> {compressed} octets")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        sys.exit("Usage : build_littlefs.py <data> <répertoire de sortie>")
+    stage_data(sys.argv[1], sys.argv[2])
+else:
+    Import("env")  # noqa: F821 (fourni par PlatformIO)
+
+    if any(target in COMMAND_LINE_TARGETS for target in ("buildfs", "uploadfs", "uploadfsota")):  # noqa: F821
+        staging = os.path.join(env.subst("$BUILD_DIR"), "littlefs_data")  # noqa: F821
+        stage_data(env.subst("$PROJECT_DATA_DIR"), staging)  # noqa: F821
+        env.Replace(PROJECT_DATA_DIR=staging)  # noqa: F821